@@ -0,0 +1,55 @@
+/*
+==============================================================================
+
+    AnalysisPipeline.cpp
+    Created: 19 Oct 2026 4:10:46am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "AnalysisPipeline.h"
+
+//==============================================================================
+namespace
+{
+    // Add an order here to support another FFT size
+    using SupportedOrders = std::integer_sequence<int, 11>;
+
+    using Factory = std::unique_ptr<AnalysisPipeline> (*)();
+
+    struct Entry
+    {
+        int order;
+        int numChannels;
+        Factory factory;
+    };
+
+    template <int Order, int NumChannels>
+    std::unique_ptr<AnalysisPipeline> makePipeline()
+    {
+        return std::make_unique<AnalysisPipelineImpl<Order, NumChannels>>();
+    }
+
+    // One entry per supported order and channel count
+    template <int... Orders>
+    constexpr std::array<Entry, sizeof... (Orders) * AnalysisPipeline::maxChannels> makeTable (std::integer_sequence<int, Orders...>)
+    {
+        static_assert (AnalysisPipeline::maxChannels == 2, "Add the new channel counts to the table");
+
+        return { Entry { Orders, 1, &makePipeline<Orders, 1> }...,
+                 Entry { Orders, 2, &makePipeline<Orders, 2> }... };
+    }
+
+    constexpr auto dispatchTable = makeTable (SupportedOrders());
+}
+
+//==============================================================================
+std::unique_ptr<AnalysisPipeline> AnalysisPipeline::create (int fftOrder, int numChannels)
+{
+    for (const auto& entry : dispatchTable)
+        if (entry.order == fftOrder && entry.numChannels == numChannels)
+            return entry.factory();
+
+    return nullptr;
+}
@@ -0,0 +1,203 @@
+/*
+==============================================================================
+
+    AnalysisPipeline.h
+    Created: 19 Oct 2026 4:10:46am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    The per-frame front end of the analyzer: FIFO, window, FFT and magnitudes.
+
+    The work is done by AnalysisPipelineImpl, which is stamped out for each
+    supported FFT order and channel count. With both known at compile time
+    every loop has a constant trip count over aligned fixed-size arrays, so
+    the compiler can unroll and vectorise them. create() picks the right
+    instantiation at runtime, prepareToPlay is the place to call it from.
+    After that it's a single virtual call per block and a few per frame.
+*/
+
+class AnalysisPipeline
+{
+public:
+    virtual ~AnalysisPipeline() = default;
+
+    // Returns nullptr if there is no instantiation for the order and channel count
+    static std::unique_ptr<AnalysisPipeline> create (int fftOrder, int numChannels);
+
+    static constexpr int maxChannels = 2;
+
+    // Hann for the display. The other two are for measuring harmonics: the
+    // Blackman-Harris leaks far less, the flat top reads levels almost exactly
+    // wherever a tone falls between bins. All are normalised to the same
+    // coherent gain, so a sine's peak reads the same through any of them.
+    enum class Window
+    {
+        hann = 0,
+        blackmanHarris,
+        flatTop
+    };
+
+    static constexpr int numWindows = 3;
+
+    virtual int getFFTOrder() const noexcept = 0;
+    virtual int getNumChannels() const noexcept = 0;
+
+    // Copies as many samples as still fit into the FIFOs, starting at startSample
+    // in each of getNumChannels() channels. Returns how many it took.
+    virtual int push (const float* const* channels, int startSample, int numSamples) noexcept = 0;
+    virtual int getNumBuffered() const noexcept = 0;
+    virtual bool isFull() const noexcept = 0;
+
+    // Windows channel 0 into getSpectrum() and transforms it, then empties the
+    // FIFOs. Their contents stay readable until the next push(). The two halves
+    // can be called separately, to time them.
+    void transform() noexcept
+    {
+        applyWindow();
+        performFFT();
+    }
+
+    virtual void applyWindow() noexcept = 0;
+
+    // Takes effect from the next applyWindow(), the tables are all made up front
+    virtual void setWindow (Window newWindow) noexcept = 0;
+    virtual void performFFT() noexcept = 0;
+
+    // Interleaved complex spectrum of the last transform, 2 * fftSize floats
+    virtual float* getSpectrum() noexcept = 0;
+    virtual const float* getFifo (int channel) const noexcept = 0;
+
+    // Magnitudes of the fftSize / 2 bins below Nyquist, each multiplied by its
+    // gain if gains isn't nullptr
+    virtual const float* computeMagnitudes (const float* gains) noexcept = 0;
+};
+
+//==============================================================================
+template <int Order, int NumChannels>
+class AnalysisPipelineImpl final : public AnalysisPipeline
+{
+public:
+    static constexpr int fftSize = 1 << Order;
+    static constexpr int numBins = fftSize / 2;
+
+    static_assert (NumChannels >= 1 && NumChannels <= maxChannels);
+
+    AnalysisPipelineImpl()
+        : fft (Order)
+    {
+        using WindowingFunction = juce::dsp::WindowingFunction<float>;
+
+        // Hann is the table the processor's WindowingFunction used to build
+        WindowingFunction::fillWindowingTables (windowTables[(size_t) Window::hann].data(), (size_t) fftSize, WindowingFunction::hann, true);
+        WindowingFunction::fillWindowingTables (windowTables[(size_t) Window::blackmanHarris].data(), (size_t) fftSize, WindowingFunction::blackmanHarris, true);
+        WindowingFunction::fillWindowingTables (windowTables[(size_t) Window::flatTop].data(), (size_t) fftSize, WindowingFunction::flatTop, true);
+        for (auto& fifo : fifos)
+            fifo.fill (0.0f);
+
+        spectrum.fill (0.0f);
+        magnitudes.fill (0.0f);
+    }
+
+    int getFFTOrder() const noexcept override    { return Order; }
+    int getNumChannels() const noexcept override { return NumChannels; }
+
+    int push (const float* const* channels, int startSample, int numSamples) noexcept override
+    {
+        auto numToCopy = juce::jmin (numSamples, fftSize - numBuffered);
+
+        for (int channel = 0; channel < NumChannels; ++channel)
+            std::copy (channels[channel] + startSample,
+                       channels[channel] + startSample + numToCopy,
+                       fifos[(size_t) channel].data() + numBuffered);
+
+        numBuffered += numToCopy;
+        return numToCopy;
+    }
+
+    int getNumBuffered() const noexcept override { return numBuffered; }
+    bool isFull() const noexcept override        { return numBuffered == fftSize; }
+
+    void applyWindow() noexcept override
+    {
+        // Windowing while copying saves a pass. Only the first half needs to be
+        // set, performRealOnlyForwardTransform doesn't read the rest.
+        const auto* input = fifos[0].data();
+        const auto* window = windowTables[(size_t) currentWindow].data();
+
+        for (int n = 0; n < fftSize; ++n)
+            spectrum[(size_t) n] = input[n] * window[n];
+
+        numBuffered = 0;
+    }
+
+    void setWindow (Window newWindow) noexcept override
+    {
+        currentWindow = newWindow;
+    }
+
+    void performFFT() noexcept override
+    {
+        fft.performRealOnlyForwardTransform (spectrum.data(), true);
+    }
+
+    float* getSpectrum() noexcept override { return spectrum.data(); }
+
+    const float* getFifo (int channel) const noexcept override
+    {
+        jassert (juce::isPositiveAndBelow (channel, NumChannels));
+        return fifos[(size_t) channel].data();
+    }
+
+    const float* computeMagnitudes (const float* gains) noexcept override
+    {
+        if (gains != nullptr)
+            return fillMagnitudes<true> (gains);
+
+        return fillMagnitudes<false> (gains);
+    }
+
+private:
+    // Two loops rather than a branch or a multiply by one in the unweighted case
+    template <bool Weighted>
+    const float* fillMagnitudes (const float* gains) noexcept
+    {
+        // A plain sqrt vectorises where std::hypot doesn't. The spectrum of a
+        // windowed float block can't get anywhere near overflowing anyway.
+        const auto* bins = spectrum.data();
+        auto* out = magnitudes.data();
+
+        for (int n = 0; n < numBins; ++n)
+        {
+            auto re = bins[2 * n];
+            auto im = bins[2 * n + 1];
+            auto magnitude = std::sqrt (re * re + im * im);
+
+            if constexpr (Weighted)
+                magnitude *= gains[n];
+
+            out[n] = magnitude;
+        }
+
+        return out;
+    }
+
+    juce::dsp::FFT fft;
+    int numBuffered = 0;
+
+    Window currentWindow = Window::hann;
+
+    alignas (64) std::array<std::array<float, (size_t) fftSize>, (size_t) numWindows> windowTables;
+    alignas (64) std::array<std::array<float, (size_t) fftSize>, (size_t) NumChannels> fifos;
+    alignas (64) std::array<float, (size_t) (2 * fftSize)> spectrum; // dsp::FFT wants 2 * getSize()
+    alignas (64) std::array<float, (size_t) numBins> magnitudes;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AnalysisPipelineImpl)
+};
@@ -11,24 +11,58 @@
 #include <JuceHeader.h>
 #include "Analyzer.h"
 #include "PluginProcessor.h"
+#include "MyColours.h"
 
 //==============================================================================
-Analyzer::Analyzer(PluginProcessor& p, double samplingRate) : processorRef (p), fs(samplingRate)
+Analyzer::Analyzer(PluginProcessor& p, double samplingRate)
+    : processorRef (p),
+      fs(samplingRate),
+      spectrogramImage (juce::Image::RGB, ReassignedSpectrogram::numCells, spectrogramRows, true)
 {
     // In your constructor, you should add any child components, and
     // initialise any special settings that your component needs.
     scopeSize = PluginProcessor::scopeSize;
     scopeData.resize(PluginProcessor::scopeSize);
+    transferMagnitude.resize(PluginProcessor::fftSize / 2);
+    transferPhase.resize(PluginProcessor::fftSize / 2);
+    coherence.resize(PluginProcessor::fftSize / 2);
+    stereoCorrelation.resize(PluginProcessor::fftSize / 2);
+    stereoPhase.resize(PluginProcessor::fftSize / 2);
+    spectrumDb.resize(PluginProcessor::fftSize / 2, -100.0f);
+    outlineDb.resize(PluginProcessor::fftSize / 2, -100.0f);
+    floorDb.resize(PluginProcessor::fftSize / 2, -100.0f);
+    differenceDb.resize(PluginProcessor::fftSize / 2, 0.0f);
+    recentOnsets.reserve (maxRecentOnsets);
+    trackerDb.resize ((size_t) ToneTracker::traceLength);
+    channelDb.resize ((size_t) MultichannelAnalyzer::maxChannels, std::vector<float> ((size_t) PluginProcessor::fftSize / 2, -200.0f));
+    referenceVersions.fill (-1);
+    spectrogramTrailDb.fill (ReassignedSpectrogram::minDb);
+
+    // Quiet to loud, looked up for every cell of every new row
+    juce::ColourGradient gradient (MyColours::black, 0.0f, 0.0f, MyColours::red, 1.0f, 0.0f, false);
+    gradient.addColour (0.4, MyColours::blue.darker (0.6f));
+    gradient.addColour (0.7, MyColours::blue);
+    gradient.addColour (0.9, MyColours::cream);
+
+    for (size_t i = 0; i < spectrogramColours.size(); ++i)
+        spectrogramColours[i] = gradient.getColourAtPosition ((double) i / (double) (spectrogramColours.size() - 1));
+
+    processorRef.getReferences().addChangeListener (this);
     startTimerHz (30);
 }
 
 Analyzer::~Analyzer()
 {
+    // The processor records while nobody's looking, too
+    processorRef.setHistoryFrozen (false);
+    processorRef.getReferences().removeChangeListener (this);
     stopTimer();
 }
 
 void Analyzer::paint (juce::Graphics& g)
 {
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::paint);
+
     /* This demo code just fills the component's background and
      draws some placeholder text to get you started.
 
@@ -36,9 +70,14 @@ void Analyzer::paint (juce::Graphics& g)
      drawing code..
     */
 
+    auto paintStart = juce::Time::getMillisecondCounterHiRes();
+
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
     drawFrame (g);
 
+    if (detail.addPaintTime (juce::Time::getMillisecondCounterHiRes() - paintStart))
+        updateRepaintRate();
+
 //  g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));   // clear the background
 //
 //  g.setColour (juce::Colours::red);
@@ -54,10 +93,66 @@ void Analyzer::resized()
 {
     // This method is where you should set the bounds of any child
     // components that your component contains..
+
+    // The budget is about physical pixels, so count them on high-DPI screens too
+    auto scale = (double) juce::Component::getApproximateScaleFactorForComponent (this);
+    detail.setArea ((double) getWidth() * (double) getHeight() * scale * scale);
+    updateRepaintRate();
+}
+
+void Analyzer::updateRepaintRate()
+{
+    // The timer is stopped while someone else drives us, leave it that way
+    auto rate = detail.getRepaintRateHz();
+
+    if (isTimerRunning() && getTimerInterval() != 1000 / rate)
+        startTimerHz (rate);
+}
+
+template <typename Callback>
+void Analyzer::forEachPoint (const std::vector<float>& levelsDb, float width, Callback&& callback) const
+{
+    // Bins that land closer together than the level of detail allows are
+    // merged into one point, keeping the loudest so no peak goes missing
+    auto numBins = (int) levelsDb.size();
+    float nyquist = fs * 0.5f;
+    auto spacing = detail.getMinimumPointSpacing();
+
+    float groupFreq = 0.0f, groupX = 0.0f, groupDb = 0.0f;
+    bool groupOpen = false;
+
+    for (int i = 0; i < numBins; ++i)
+    {
+      float freq = (float) i / (float) numBins * nyquist;
+      float x = frequencyToX (freq, width);
+
+      if (groupOpen && x - groupX >= spacing)
+      {
+          callback (groupFreq, groupX, groupDb);
+          groupOpen = false;
+      }
+
+      if (groupOpen)
+      {
+          groupDb = juce::jmax (groupDb, levelsDb[(size_t) i]);
+      }
+      else
+      {
+          groupFreq = freq;
+          groupX = x;
+          groupDb = levelsDb[(size_t) i];
+          groupOpen = true;
+      }
+    }
+
+    if (groupOpen)
+      callback (groupFreq, groupX, groupDb);
 }
 
 void Analyzer::drawNextFrameOfSpectrum()
 {
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::nextFrame);
+
     auto mindB = -80.0f;
     auto maxdB =    0.0f;
 
@@ -83,10 +178,76 @@ void Analyzer::drawNextFrameOfSpectrum()
 
         scopeData[i] = level;
     }
+
+    // Convert to dB once per frame, the paint calls only read these
+    auto referenceDb = juce::Decibels::gainToDecibels ((float) PluginProcessor::fftSize);
+    const auto* heldLevels = processorRef.heldFftData;
+
+    for (size_t n = 0; n < spectrumDb.size(); ++n)
+    {
+        spectrumDb[n] = juce::Decibels::gainToDecibels (smoothedFftData[n]) - referenceDb;
+        outlineDb[n]  = juce::Decibels::gainToDecibels (heldLevels[n]) - referenceDb;
+    }
+
+    if (processorRef.isNoiseFloorShown())
+    {
+        const auto* floorLevels = processorRef.noiseFloorData;
+
+        for (size_t n = 0; n < floorDb.size(); ++n)
+            floorDb[n] = juce::Decibels::gainToDecibels (floorLevels[n]) - referenceDb;
+    }
+
+    peaks = processorRef.spectralPeaks;
+
+    const auto& transferFunction = processorRef.getTransferFunction();
+    auto numBins = (size_t) transferFunction.getNumBins();
+    std::copy (transferFunction.getMagnitude(), transferFunction.getMagnitude() + numBins, transferMagnitude.begin());
+    std::copy (transferFunction.getPhase(), transferFunction.getPhase() + numBins, transferPhase.begin());
+    std::copy (transferFunction.getCoherence(), transferFunction.getCoherence() + numBins, coherence.begin());
+
+    const auto& stereo = processorRef.getStereoCorrelation();
+    std::copy (stereo.getCorrelation(), stereo.getCorrelation() + numBins, stereoCorrelation.begin());
+    std::copy (stereo.getPhaseDifference(), stereo.getPhaseDifference() + numBins, stereoPhase.begin());
+    broadbandCorrelation = stereo.getBroadbandCorrelation();
+
+    levels = processorRef.levelReadings;
+    bands = processorRef.bandLevels;
+    harmonics = processorRef.harmonicReadings;
+
+    if (processorRef.arePercentilesShown())
+      percentiles = processorRef.percentileLevels;
+
+    // The lanes come from the worker threads, whenever they've finished a frame
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::channels
+        && processorRef.getMultichannelAnalyzer().readLevels (channelDb)
+        && channelNames.size() != processorRef.getMultichannelAnalyzer().getNumChannels())
+      channelNames = processorRef.getInputChannelNames();
+
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::spectrogram
+        && processorRef.spectrogramSlices.numSlices > 0)
+      addSpectrogramRows (processorRef.spectrogramSlices);
+
+    const auto& onsets = processorRef.onsets;
+
+    // A restarted processor counts from zero again, so anything ahead of it is stale
+    if (onsets.frameEnd < latestFrameEnd)
+      recentOnsets.clear();
+
+    latestFrameEnd = onsets.frameEnd;
+
+    auto oldest = latestFrameEnd - (juce::int64) (onsetLaneSeconds * fs);
+    recentOnsets.erase (recentOnsets.begin(),
+                        std::find_if (recentOnsets.begin(), recentOnsets.end(),
+                                      [oldest] (const auto& onset) { return onset.onsetSample >= oldest; }));
+
+    if (onsets.isOnset && recentOnsets.size() < maxRecentOnsets)
+      recentOnsets.push_back (onsets);
 }
 
 void Analyzer::drawGrid(juce::Graphics& g, float width, float height, float mindB, float maxdB)
 {
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawGrid);
+
     // Colors and styles
     g.setColour(juce::Colours::grey);
     g.setOpacity(0.5f);
@@ -145,73 +306,51 @@ void Analyzer::drawVerticalLineForFrequency(juce::Graphics& g, float freq, float
 
 void Analyzer::drawSpectrum(juce::Graphics& g, float width, float height, float mindB, float maxdB)
 {
-    int numFFTPoints = PluginProcessor::fftSize / 2;
-    auto smoothedFftData = processorRef.smoothedFftData;
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawSpectrum);
+
     float nyquist = fs * 0.5f;
     float minFrequency = 20.0f;  // Starting from 20Hz
 
-    for (int i = 0; i < numFFTPoints; ++i)
+    forEachPoint (spectrumDb, width, [&] (float freq, float, float levelDb)
     {
-      float proportion = (float)i / (float)numFFTPoints;
-      float freq = proportion * nyquist;
-
       // Draw the spectrum using vertical lines
-      float level = juce::jmap(juce::jlimit(mindB, maxdB, juce::Decibels::gainToDecibels(smoothedFftData[i])
-                                                                - juce::Decibels::gainToDecibels((float)PluginProcessor::fftSize)),
-          mindB, maxdB, 0.0f, (float)getLocalBounds().getHeight());
+      float level = juce::jmap(juce::jlimit(mindB, maxdB, levelDb), mindB, maxdB, 0.0f, height);
 
       drawVerticalLineForFrequency(g, freq, level, width, height, nyquist, minFrequency, 1.5);
-    }
+    });
 }
 
 void Analyzer::drawOutline(juce::Graphics& g, float width, float height, float mindB, float maxdB)
 {
-    int numFFTPoints = PluginProcessor::fftSize / 2;
-    auto smoothedFftData = processorRef.maxSmoothedFftData;
-    float nyquist = fs * 0.5f;
-    float minFrequency = 20.0f;  // Starting from 20Hz
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawOutline);
 
     juce::Path outlinePath;  // This will store the outline of the spectrum
+    bool firstPoint = true;
 
-    for (int i = 0; i < numFFTPoints; ++i)
+    forEachPoint (outlineDb, width, [&] (float, float x, float levelDb)
     {
-      float proportion = (float)i / (float)numFFTPoints;
-      float freq = proportion * nyquist;
-
       // dB level sets vertical position
-      float level = juce::jmap(juce::jlimit(mindB, maxdB, juce::Decibels::gainToDecibels(smoothedFftData[i])
-                                                                - juce::Decibels::gainToDecibels((float)PluginProcessor::fftSize)),
-          mindB, maxdB, 0.0f, (float)height);
-
-      // Horizontal position uses logarithmic scaling
-      float logX;
-      float x;
-
-      if (freq < minFrequency)
-      {
-          x = 0;
-      } else
-      {
-          logX = (std::log(freq) - std::log(minFrequency)) / (std::log(nyquist) - std::log(minFrequency));
-          x = logX * width;
-      }
+      float level = juce::jmap(juce::jlimit(mindB, maxdB, levelDb), mindB, maxdB, 0.0f, (float)height);
 
       // Add the point to the outline path
-      if (i == 0)  // If it's the first point, start a new sub-path
+      if (firstPoint)  // If it's the first point, start a new sub-path
           outlinePath.startNewSubPath(x, height - level);
       else
           outlinePath.lineTo(x, height - level);
-    }
 
-    // Create a rounded version of the outline path
-    juce::Path roundedOutline = outlinePath.createPathWithRoundedCorners(20.0f);  // Adjust the rounding radius as needed
+      firstPoint = false;
+    });
+
+    // Create a rounded version of the outline path, less rounded the less detail we can afford
+    auto rounding = detail.getOutlineRounding();
+    juce::Path roundedOutline = rounding > 0.0f ? outlinePath.createPathWithRoundedCorners(rounding) : outlinePath;
 
     // Draw the rounded outline (only the top edge)
     g.strokePath(roundedOutline, juce::PathStrokeType(2.0f));  // Adjust the stroke type as needed
 
     // Fill in outline
-    roundedOutline.lineTo (getLocalBounds().getBottomRight().toFloat());
-    roundedOutline.lineTo (getLocalBounds().getBottomLeft().toFloat());
+    roundedOutline.lineTo (width, height);
+    roundedOutline.lineTo (0.0f, height);
     roundedOutline.closeSubPath();
     g.fillPath (roundedOutline);
 }
@@ -224,6 +363,11 @@ void Analyzer::drawFrame(juce::Graphics& g)
     float mindB = -80.0f; // Adjust as needed
     float maxdB = 0.0f;   // Adjust as needed
 
+    // Level meters sit in a strip on the right, whatever the display mode
+    auto meterWidth = 56;
+    width -= meterWidth;
+    drawLevelMeters(g, juce::Rectangle<int> (width, 0, meterWidth, height).toFloat());
+
 //    juce::Path path;
 //    path.preallocateSpace(8 + scopeSize * 3);
 //    path.startNewSubPath (
@@ -250,14 +394,64 @@ void Analyzer::drawFrame(juce::Graphics& g)
 //    path.closeSubPath();
 //    g.fillPath (path.createPathWithRoundedCorners(2));
 
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::transferFunction)
+    {
+      // Transfer function gain sits around 0 dB, so centre the grid on it
+      drawGrid(g, width, height, -30.0f, 30.0f);
+      drawTransferFunction(g, width, height, -30.0f, 30.0f);
+      return;
+    }
+
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::tracker)
+    {
+      drawTracker(g, width, height, mindB, maxdB);
+      return;
+    }
+
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::channels)
+    {
+      drawChannelLanes(g, width, height, mindB, maxdB);
+      return;
+    }
+
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::spectrogram)
+    {
+      drawSpectrogram(g, width, height);
+      return;
+    }
+
+    if (PluginProcessor::isRtaMode (processorRef.getDisplayMode()))
+    {
+      drawGrid(g, width, height, mindB, maxdB);
+      drawBands(g, width, height, mindB, maxdB);
+      return;
+    }
+
+    // The phase lane takes the bottom quarter when it's on and there's a stereo input
+    if (processorRef.isPhaseLaneVisible() && processorRef.stereoActive.load())
+    {
+      auto laneHeight = height / 4;
+      height -= laneHeight;
+      drawPhaseLane(g, juce::Rectangle<int> (0, height, width, laneHeight).toFloat());
+    }
+
     // First draw the grid
     drawGrid(g, width, height, mindB, maxdB);
 
     // Change color
     g.setColour(juce::Colours::grey);
 
-    // Then draw spectrum outline
-    drawOutline(g, width, height, mindB, maxdB);
+    // Then draw spectrum outline, which the history doesn't keep
+    if (not paused)
+      drawOutline(g, width, height, mindB, maxdB);
+
+    // Statistics under the live spectrum, not gathered in harmonics mode
+    if (processorRef.arePercentilesShown() && processorRef.getDisplayMode() != PluginProcessor::DisplayMode::harmonics)
+      drawPercentiles(g, width, height, mindB, maxdB);
+
+    // The floor belongs to the live frame like the outline, and isn't tracked in harmonics mode either
+    if (not paused && processorRef.isNoiseFloorShown() && processorRef.getDisplayMode() != PluginProcessor::DisplayMode::harmonics)
+      drawNoiseFloor(g, width, height, mindB, maxdB);
 
     // Change color
     g.setColour(juce::Colours::white);
@@ -265,17 +459,889 @@ void Analyzer::drawFrame(juce::Graphics& g)
     // Now plot the spectrum
     drawSpectrum(g, width, height, mindB, maxdB);
 
+    // Stored references on top, with the difference to one of them if asked for
+    drawReferences(g, width, height, mindB, maxdB);
+
+    // Label the peaks found by the processor, or the harmonics when measuring them,
+    // then the readout under the mouse. Both belong to the live frame, so they go
+    // while looking at the history.
+    if (not paused)
+    {
+      if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::harmonics)
+        drawHarmonics(g, width, height, mindB, maxdB);
+      else
+        drawPeaks(g, width, height, mindB, maxdB);
+    }
+    drawHoverReadout(g, width, height, mindB, maxdB);
+
+    if (paused)
+      drawTimeline(g, width);
+    else
+      drawOnsets(g, width);
+
+}
+
+void Analyzer::drawBands(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawMode);
+
+    auto toY = [&] (float levelDb) { return juce::jmap (juce::jlimit (mindB, maxdB, levelDb), mindB, maxdB, height, 0.0f); };
+
+    for (int b = 0; b < bands.numBands; ++b)
+    {
+      // One bar per band between its edges, with a pixel of gap either side
+      auto left  = frequencyToX (bands.lowerFrequency[(size_t) b], width) + 1.0f;
+      auto right = frequencyToX (bands.upperFrequency[(size_t) b], width) - 1.0f;
+
+      if (right <= left)
+        continue;
+
+      auto top = toY (bands.levelDb[(size_t) b]);
+
+      g.setColour (MyColours::cream);
+      g.fillRect (juce::Rectangle<float>::leftTopRightBottom (left, top, right, height));
+
+      // Held peak as a line over the bar
+      g.setColour (MyColours::red);
+      g.fillRect (juce::Rectangle<float> (left, toY (bands.peakDb[(size_t) b]) - 1.0f, right - left, 2.0f));
+    }
+}
+
+void Analyzer::drawOnsets(juce::Graphics& g, float width)
+{
+    // Newest on the right. Ticks get taller the further the flux cleared the threshold
+    // and fade as they scroll away.
+    for (const auto& onset : recentOnsets)
+    {
+      auto age = (float) ((double) (latestFrameEnd - onset.onsetSample) / fs);
+      auto x = width * (1.0f - age / (float) onsetLaneSeconds);
+      auto tickHeight = juce::jmap (juce::jlimit (1.0f, 4.0f, onset.strength), 1.0f, 4.0f, 4.0f, 12.0f);
+
+      g.setColour (MyColours::red.withAlpha (1.0f - 0.8f * age / (float) onsetLaneSeconds));
+      g.fillRect (juce::Rectangle<float> (x - 1.0f, 0.0f, 2.0f, tickHeight));
+    }
+}
+
+void Analyzer::drawPercentiles(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawPercentiles);
+
+    if (percentiles.numColumns == 0)
+      return;
+
+    auto levelToY = [&] (float levelDb) { return juce::jmap (juce::jlimit (mindB, maxdB, levelDb), mindB, maxdB, height, 0.0f); };
+
+    auto& points = percentilePoints;
+
+    for (size_t p = 0; p < points.size(); ++p)
+    {
+      const auto& levels = percentiles.levelsDb[p];
+      percentileDb[p].assign (levels.begin(), levels.begin() + percentiles.numColumns);
+      points[p].clear();
+
+      forEachPoint (percentileDb[p], width, [&] (float, float x, float levelDb)
+      {
+        points[p].push_back ({ x, levelToY (levelDb) });
+      });
+    }
+
+    // L10 to L90 as a band, along the top and back along the bottom, with L50 through it
+    const auto& top = points.front();
+    const auto& bottom = points.back();
+    const auto& middle = points[points.size() / 2];
+
+    if (top.empty())
+      return;
+
+    juce::Path band;
+    band.startNewSubPath (top.front());
+
+    for (size_t i = 1; i < top.size(); ++i)
+      band.lineTo (top[i]);
+
+    for (auto i = bottom.rbegin(); i != bottom.rend(); ++i)
+      band.lineTo (*i);
+
+    band.closeSubPath();
+
+    g.setColour (MyColours::cream.withAlpha (0.15f));
+    g.fillPath (band);
+
+    juce::Path median;
+    median.startNewSubPath (middle.front());
+
+    for (size_t i = 1; i < middle.size(); ++i)
+      median.lineTo (middle[i]);
+
+    g.setColour (MyColours::cream.withAlpha (0.6f));
+    g.strokePath (median, juce::PathStrokeType (1.0f));
+
+    // What the statistics cover, bottom left
+    auto seconds = juce::roundToInt (percentiles.seconds);
+    auto covered = juce::String (seconds / 60) + ":" + juce::String (seconds % 60).paddedLeft ('0', 2);
+
+    g.setFont (12.0f);
+    g.drawText ("L10-L90, L50 over " + covered,
+                juce::Rectangle<float> (4.0f, height - 18.0f, 160.0f, 14.0f),
+                juce::Justification::bottomLeft, false);
+}
+
+void Analyzer::drawNoiseFloor(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawNoiseFloor);
+
+    auto levelToY = [&] (float levelDb) { return juce::jmap (juce::jlimit (mindB, maxdB, levelDb), mindB, maxdB, height, 0.0f); };
+
+    // Both traces have the same bins, so forEachPoint groups them the same way
+    floorPoints.clear();
+    floorLevels.clear();
+
+    forEachPoint (floorDb, width, [&] (float, float x, float levelDb)
+    {
+      floorPoints.push_back ({ x, levelToY (levelDb) });
+      floorLevels.push_back (levelDb);
+    });
+
+    if (floorPoints.empty())
+      return;
+
+    if (processorRef.isSnrShadingOn())
+    {
+      // The gap between the floor and the spectrum, coloured by how far the
+      // spectrum clears it: red under 10 dB, cream to 30 dB and blue beyond.
+      // One path per colour, so it's three fills however many points there are.
+      std::array<juce::Path, 3> shading;
+      size_t i = 0;
+
+      forEachPoint (spectrumDb, width, [&] (float, float x, float levelDb)
+      {
+        auto snr = levelDb - floorLevels[i];
+        auto right = i + 1 < floorPoints.size() ? floorPoints[i + 1].x : width;
+        auto top = levelToY (levelDb);
+
+        if (snr > 0.0f && top < floorPoints[i].y)
+          shading[snr < 10.0f ? 0 : (snr < 30.0f ? 1 : 2)].addRectangle (x, top, right - x, floorPoints[i].y - top);
+
+        ++i;
+      });
+
+      const juce::Colour colours[] = { MyColours::red, MyColours::cream, MyColours::blue };
+
+      for (size_t c = 0; c < shading.size(); ++c)
+      {
+        g.setColour (colours[c].withAlpha (0.25f));
+        g.fillPath (shading[c]);
+      }
+    }
+
+    juce::Path trace;
+    trace.startNewSubPath (floorPoints.front());
+
+    for (size_t i = 1; i < floorPoints.size(); ++i)
+      trace.lineTo (floorPoints[i]);
+
+    g.setColour (MyColours::red.withAlpha (0.7f));
+    g.strokePath (trace, juce::PathStrokeType (1.0f));
+
+    // Bottom right, the percentiles have the left
+    g.setFont (12.0f);
+    g.drawText ("Noise floor", juce::Rectangle<float> (width - 84.0f, height - 18.0f, 80.0f, 14.0f),
+                juce::Justification::bottomRight, false);
+}
+
+void Analyzer::drawChannelLanes(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawMode);
+
+    auto numChannels = processorRef.getMultichannelAnalyzer().getNumChannels();
+
+    if (numChannels == 0)
+      return;
+
+    // Decades across every lane
+    g.setColour (juce::Colours::grey.withAlpha (0.5f));
+
+    for (auto freq : { 100.0f, 1000.0f, 10000.0f })
+    {
+      auto x = frequencyToX (freq, width);
+      g.drawLine (x, 0.0f, x, height, 1.0f);
+    }
+
+    auto laneHeight = height / (float) numChannels;
+    g.setFont (juce::jmin (12.0f, laneHeight - 2.0f));
+
+    for (int c = 0; c < numChannels; ++c)
+    {
+      auto top = laneHeight * (float) c;
+      auto bottom = top + laneHeight;
+
+      juce::Path lane;
+      lane.startNewSubPath (0.0f, bottom);
+
+      forEachPoint (channelDb[(size_t) c], width, [&] (float, float x, float levelDb)
+      {
+        lane.lineTo (x, juce::jmap (juce::jlimit (mindB, maxdB, levelDb), mindB, maxdB, bottom, top));
+      });
+
+      lane.lineTo (width, bottom);
+      lane.closeSubPath();
+
+      g.setColour (MyColours::blue.withAlpha (0.6f));
+      g.fillPath (lane);
+
+      g.setColour (MyColours::midGrey);
+      g.drawLine (0.0f, bottom, width, bottom, 1.0f);
+
+      g.setColour (MyColours::cream);
+      g.drawText (c < channelNames.size() ? channelNames[c] : juce::String (c + 1),
+                  juce::Rectangle<float> (4.0f, top + 1.0f, 40.0f, laneHeight - 2.0f),
+                  juce::Justification::topLeft, false);
+    }
+}
+
+void Analyzer::addSpectrogramRows (const ReassignedSpectrogram::Result& slices)
+{
+    juce::Image::BitmapData pixels (spectrogramImage, juce::Image::BitmapData::writeOnly);
+    auto maxIndex = (float) (spectrogramColours.size() - 1);
+
+    // Oldest slice first, each one a row above the last
+    for (int slice = 0; slice < slices.numSlices; ++slice)
+    {
+      spectrogramRow = (spectrogramRow + spectrogramRows - 1) % spectrogramRows;
+      const auto& levelsDb = slices.levelsDb[(size_t) slice];
+
+      for (int cell = 0; cell < ReassignedSpectrogram::numCells; ++cell)
+      {
+        // A steady tone all lands on the middle of its frame, so each cell fades
+        // rather than going dark straight after
+        auto& trailDb = spectrogramTrailDb[(size_t) cell];
+        trailDb = juce::jmax (levelsDb[(size_t) cell], trailDb - spectrogramFadeDb);
+
+        auto index = juce::jmap (juce::jlimit (spectrogramMinDb, 0.0f, trailDb), spectrogramMinDb, 0.0f, 0.0f, maxIndex);
+        pixels.setPixelColour (cell, spectrogramRow, spectrogramColours[(size_t) index]);
+      }
+    }
+}
+
+void Analyzer::drawSpectrogram(juce::Graphics& g, float width, float height)
+{
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawMode);
+
+    // The cells span the same log axis as frequencyToX, so the image just stretches
+    // across. The ring is drawn in two pieces, newest row first.
+    auto newestRows = spectrogramRows - spectrogramRow;
+    auto splitY = juce::roundToInt (height * (float) newestRows / (float) spectrogramRows);
+    auto imageWidth = spectrogramImage.getWidth();
+
+    g.setImageResamplingQuality (juce::Graphics::lowResamplingQuality);
+    g.drawImage (spectrogramImage, 0, 0, (int) width, splitY, 0, spectrogramRow, imageWidth, newestRows);
+
+    if (spectrogramRow > 0)
+      g.drawImage (spectrogramImage, 0, splitY, (int) width, (int) height - splitY, 0, 0, imageWidth, spectrogramRow);
+
+    g.setColour (juce::Colours::grey.withAlpha (0.5f));
+    g.setFont (12.0f);
+
+    for (auto freq : { 100.0f, 1000.0f, 10000.0f })
+    {
+      auto x = frequencyToX (freq, width);
+      g.drawLine (x, 0.0f, x, height, 1.0f);
+      g.drawText (frequencyToText (freq), juce::Rectangle<float> (x + 3.0f, height - 16.0f, 50.0f, 14.0f),
+                  juce::Justification::left, false);
+    }
+
+    // A second's worth of rows between the time marks
+    auto rowsPerSecond = (float) (fs / PluginProcessor::fftSize) * (float) ReassignedSpectrogram::slicesPerFrame;
+    auto secondHeight = height * rowsPerSecond / (float) spectrogramRows;
+
+    for (auto y = secondHeight; y < height; y += secondHeight)
+      g.drawLine (0.0f, y, width, y, 1.0f);
+}
+
+void Analyzer::drawTracker(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    const PerformanceCounters::ScopedTimer timer (processorRef.getPerformanceCounters(), PerformanceCounters::Stage::drawMode);
+
+    // Time runs right to left, newest at the right edge
+    g.setColour (juce::Colours::grey.withAlpha (0.5f));
+
+    for (float db = mindB; db <= maxdB; db += 10.0f)
+    {
+      auto y = juce::jmap (db, mindB, maxdB, height, 0.0f);
+      g.drawLine (0.0f, y, width, y, 1.0f);
+    }
+
+    for (double seconds = 0.5; seconds < trackerSeconds; seconds += 0.5)
+    {
+      auto x = width * (float) (1.0 - seconds / trackerSeconds);
+      g.drawLine (x, 0.0f, x, height, 1.0f);
+    }
+
+    const std::array<juce::Colour, ToneTracker::maxTargets> colours
+        { MyColours::blue, MyColours::red, MyColours::cream, juce::Colours::orange,
+          juce::Colours::lightgreen, juce::Colours::violet, juce::Colours::gold, juce::Colours::turquoise };
+
+    const auto& tracker = processorRef.getToneTracker();
+    auto numPoints = (int) (trackerSeconds * ToneTracker::traceRate);
+    auto legend = juce::Rectangle<float> (8.0f, 8.0f, 160.0f, 14.0f);
+    g.setFont (12.0f);
+
+    for (int t = 0; t < tracker.getNumTargets(); ++t)
+    {
+      auto numRead = tracker.readTrace (t, trackerDb.data(), numPoints);
+
+      if (numRead == 0)
+        continue;
+
+      // A point per pixel column at most, keeping the loudest so short bursts still show
+      juce::Path trace;
+      bool firstPoint = true;
+      auto column = -1;
+      auto columnDb = mindB;
+
+      auto addColumn = [&]
+      {
+        auto y = juce::jmap (juce::jlimit (mindB, maxdB, columnDb), mindB, maxdB, height, 0.0f);
+
+        if (firstPoint)
+          trace.startNewSubPath ((float) column, y);
+        else
+          trace.lineTo ((float) column, y);
+
+        firstPoint = false;
+      };
+
+      for (int n = 0; n < numRead; ++n)
+      {
+        // Points are oldest first, and the last one sits on the right edge
+        auto x = (int) (width * (1.0f - (float) (numRead - 1 - n) / (float) numPoints));
+
+        if (x != column)
+        {
+          if (column >= 0)
+            addColumn();
+
+          column = x;
+          columnDb = trackerDb[(size_t) n];
+        }
+        else
+        {
+          columnDb = juce::jmax (columnDb, trackerDb[(size_t) n]);
+        }
+      }
+
+      addColumn();
+
+      g.setColour (colours[(size_t) t]);
+      g.strokePath (trace, juce::PathStrokeType (1.5f));
+
+      g.drawText (frequencyToText (tracker.getTrackedFrequency (t)) + "  " + juce::String (trackerDb[(size_t) numRead - 1], 1) + " dB",
+                  legend, juce::Justification::centredLeft, false);
+      legend.translate (0.0f, 14.0f);
+    }
+}
+
+void Analyzer::drawHarmonics(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    g.setFont (12.0f);
+    auto readout = juce::Rectangle<float> (width - 170.0f, 16.0f, 160.0f, 72.0f);
+
+    if (not harmonics.isValid)
+    {
+      g.setColour (MyColours::cream);
+      g.drawText ("No test tone", readout.removeFromTop (14.0f), juce::Justification::centredRight, false);
+      return;
+    }
+
+    // A marker over each harmonic, numbered, the fundamental is 1
+    for (int h = 0; h < harmonics.numHarmonics; ++h)
+    {
+      const auto& harmonic = harmonics.harmonics[(size_t) h];
+      auto x = frequencyToX (harmonic.frequency, width);
+      auto y = juce::jmap (juce::jlimit (mindB, maxdB, harmonic.level), mindB, maxdB, height, 0.0f);
+
+      juce::Path marker;
+      marker.addTriangle (x - 4.0f, y - 10.0f, x + 4.0f, y - 10.0f, x, y - 3.0f);
+
+      g.setColour (h == 0 ? MyColours::red : MyColours::blue);
+      g.fillPath (marker);
+
+      g.setColour (MyColours::cream);
+      g.drawText (juce::String (h + 1), juce::Rectangle<float> (x - 10.0f, y - 24.0f, 20.0f, 12.0f),
+                  juce::Justification::centred, false);
+    }
+
+    const auto& fundamental = harmonics.harmonics[0];
+    juce::StringArray lines { frequencyToText (fundamental.frequency) + "  " + juce::String (fundamental.level, 1) + " dB",
+                              "THD  " + juce::String (harmonics.thd, 4) + " %",
+                              "THD+N  " + juce::String (harmonics.thdN, 4) + " %",
+                              "SNR  " + juce::String (harmonics.snr, 1) + " dB" };
+
+    g.setColour (MyColours::blackGrey.withAlpha (0.8f));
+    g.fillRoundedRectangle (readout, 4.0f);
+    g.setColour (MyColours::cream);
+
+    readout.reduce (8.0f, 8.0f);
+
+    for (const auto& line : lines)
+      g.drawText (line, readout.removeFromTop (14.0f), juce::Justification::centredRight, false);
+}
+
+void Analyzer::drawPeaks(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    g.setFont (12.0f);
+
+    for (int i = 0; i < peaks.numPeaks; ++i)
+    {
+      const auto& peak = peaks.peaks[(size_t) i];
+      auto x = frequencyToX (peak.frequency, width);
+      auto y = juce::jmap (juce::jlimit (mindB, maxdB, peak.level), mindB, maxdB, height, 0.0f);
+
+      g.setColour (MyColours::red);
+      g.fillEllipse (x - 3.0f, y - 3.0f, 6.0f, 6.0f);
+
+      // Keep the label inside the component when the peak is near an edge
+      auto labelArea = juce::Rectangle<float> (x - 35.0f, y - 20.0f, 70.0f, 14.0f)
+                           .constrainedWithin (getLocalBounds().toFloat());
+
+      g.setColour (MyColours::cream);
+      g.drawText (frequencyToText (peak.frequency), labelArea, juce::Justification::centred, false);
+    }
+}
+
+void Analyzer::drawHoverReadout(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    if (not mousePosition.has_value())
+      return;
+
+    auto freq = xToFrequency (mousePosition->x, width);
+    float level;
+
+    // Snap to a nearby peak so the readout shows its interpolated values
+    const PeakDetector::Peak* nearest = nullptr;
+    auto nearestDistance = 12.0f;
+
+    for (int i = 0; i < (paused ? 0 : peaks.numPeaks); ++i)
+    {
+      auto distance = std::abs (frequencyToX (peaks.peaks[(size_t) i].frequency, width) - mousePosition->x);
+
+      if (distance < nearestDistance)
+      {
+          nearest = &peaks.peaks[(size_t) i];
+          nearestDistance = distance;
+      }
+    }
+
+    if (nearest != nullptr)
+    {
+      freq = nearest->frequency;
+      level = nearest->level;
+    }
+    else
+    {
+      int numFFTPoints = PluginProcessor::fftSize / 2;
+      auto bin = juce::jlimit (0, numFFTPoints - 1, juce::roundToInt (freq / (fs * 0.5f) * numFFTPoints));
+      level = spectrumDb[(size_t) bin];
+    }
+
+    auto x = frequencyToX (freq, width);
+    auto y = juce::jmap (juce::jlimit (mindB, maxdB, level), mindB, maxdB, height, 0.0f);
+
+    g.setColour (MyColours::cream.withAlpha (0.5f));
+    g.drawVerticalLine (juce::roundToInt (x), 0.0f, height);
+    g.drawHorizontalLine (juce::roundToInt (y), 0.0f, width);
+
+    auto text = frequencyToText (freq) + "  " + juce::String (level, 1) + " dB";
+
+    g.setColour (MyColours::black.withAlpha (0.7f));
+    g.fillRect (width - 130.0f, 4.0f, 126.0f, 18.0f);
+    g.setColour (MyColours::cream);
+    g.setFont (13.0f);
+    g.drawText (text, juce::Rectangle<float> (width - 130.0f, 4.0f, 126.0f, 18.0f), juce::Justification::centred, false);
+}
+
+void Analyzer::drawTransferFunction(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    g.setFont (13.0f);
+
+    if (not processorRef.sidechainActive.load())
+    {
+      g.setColour (MyColours::grey);
+      g.drawText ("Connect a reference signal to the sidechain input", getLocalBounds(), juce::Justification::centred, false);
+      return;
+    }
+
+    // Coherence on a 0 to 1 scale over the full height, phase over +/- pi
+    g.setColour (MyColours::midGrey);
+    drawTrace (g, coherence, width, height, 0.0f, 1.0f, 1.5f);
+
+    g.setColour (MyColours::blue.withAlpha (0.6f));
+    drawTrace (g, transferPhase, width, height, -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi, 1.0f);
+
+    g.setColour (juce::Colours::white);
+    drawTrace (g, transferMagnitude, width, height, mindB, maxdB, 2.0f);
 
+    auto delay = processorRef.getTransferFunction().getDelay();
+    auto delayText = processorRef.getTransferFunction().isDelaySearchPending()
+                       ? juce::String ("Delay: searching...")
+                       : "Delay: " + juce::String (delay * 1000.0 / fs, 2) + " ms (" + juce::String (delay) + " samples)";
+
+    g.setColour (MyColours::cream);
+    g.drawText (delayText, juce::Rectangle<float> (6.0f, 4.0f, 250.0f, 18.0f), juce::Justification::centredLeft, false);
+}
+
+void Analyzer::drawPhaseLane(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    // Spectrum above stays clipped to its own area
+    juce::Graphics::ScopedSaveState state (g);
+    g.reduceClipRegion (area.toNearestInt());
+
+    g.setColour (MyColours::blackGrey);
+    g.fillRect (area);
+
+    // Zero correlation line, +1 at the top of the lane and -1 at the bottom
+    g.setColour (MyColours::midGrey);
+    g.drawHorizontalLine (juce::roundToInt (area.getCentreY()), area.getX(), area.getRight());
+
+    g.addTransform (juce::AffineTransform::translation (area.getX(), area.getY()));
+
+    g.setColour (MyColours::blue.withAlpha (0.4f));
+    drawTrace (g, stereoPhase, area.getWidth(), area.getHeight(), -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi, 1.0f);
+
+    g.setColour (MyColours::cream);
+    drawTrace (g, stereoCorrelation, area.getWidth(), area.getHeight(), -1.0f, 1.0f, 1.5f);
+
+    // Broadband correlation meter across the top of the lane, filled from the centre
+    auto meter = juce::Rectangle<float> (0.0f, 0.0f, area.getWidth(), 5.0f);
+    auto centre = meter.getCentreX();
+    auto end = centre + broadbandCorrelation * meter.getWidth() * 0.5f;
+
+    g.setColour (broadbandCorrelation < 0.0f ? MyColours::red : MyColours::blue);
+    g.fillRect (juce::Rectangle<float>::leftTopRightBottom (juce::jmin (centre, end), 0.0f, juce::jmax (centre, end), meter.getBottom()));
+
+    g.setColour (MyColours::cream);
+    g.setFont (12.0f);
+    g.drawText ("Corr " + juce::String (broadbandCorrelation, 2),
+                juce::Rectangle<float> (4.0f, 6.0f, 80.0f, 14.0f), juce::Justification::centredLeft, false);
+}
+
+void Analyzer::drawLevelMeters(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    area.removeFromLeft (4.0f);
+
+    g.setColour (MyColours::black);
+    g.fillRect (area);
+
+    // Readouts on top
+    g.setFont (11.0f);
+    g.setColour (MyColours::cream);
+
+    auto drawReadout = [&] (const juce::String& name, float value)
+    {
+      g.drawText (name + " " + (value <= -100.0f ? juce::String ("-inf") : juce::String (value, 1)),
+                  area.removeFromTop (14.0f), juce::Justification::centred, false);
+    };
+
+    // A wider input than stereo is only met and displayed by its first two
+    // channels, except in the lanes. The tag heads the strip beside every mode.
+    if (auto channelsLabel = processorRef.getAnalysedChannelsLabel(); channelsLabel.isNotEmpty())
+    {
+      g.setColour (MyColours::red);
+      g.drawFittedText (channelsLabel, area.removeFromTop (14.0f).toNearestInt(), juce::Justification::centred, 1, 0.7f);
+      g.setColour (MyColours::cream);
+    }
+
+    drawReadout ("TP", levels.truePeak);
+    drawReadout ("RMS", levels.rms);
+    drawReadout ("M", levels.momentary);
+    drawReadout ("S", levels.shortTerm);
+
+    // Then two bars over -60 to 0: peak with RMS inside it, and momentary with a short-term tick
+    auto meterFloor = -60.0f;
+    auto bars = area.reduced (4.0f);
+    auto peakBar = bars.removeFromLeft (bars.getWidth() * 0.5f).reduced (2.0f, 0.0f);
+    auto loudnessBar = bars.reduced (2.0f, 0.0f);
+
+    auto levelToY = [&] (juce::Rectangle<float> bar, float level)
+    {
+      return juce::jmap (juce::jlimit (meterFloor, 0.0f, level), meterFloor, 0.0f, bar.getBottom(), bar.getY());
+    };
+
+    g.setColour (MyColours::blackGrey);
+    g.fillRect (peakBar);
+    g.fillRect (loudnessBar);
+
+    g.setColour (levels.truePeak > 0.0f ? MyColours::red : MyColours::blue);
+    g.fillRect (peakBar.withTop (levelToY (peakBar, levels.peak)));
+    g.setColour (MyColours::cream);
+    g.fillRect (peakBar.withTop (levelToY (peakBar, levels.rms)).reduced (2.0f, 0.0f));
+
+    g.setColour (MyColours::blue);
+    g.fillRect (loudnessBar.withTop (levelToY (loudnessBar, levels.momentary)));
+    g.setColour (MyColours::cream);
+    g.drawHorizontalLine (juce::roundToInt (levelToY (loudnessBar, levels.shortTerm)), loudnessBar.getX(), loudnessBar.getRight());
+}
+
+void Analyzer::drawTrace(juce::Graphics& g, const std::vector<float>& values, float width, float height, float minValue, float maxValue, float thickness)
+{
+    g.strokePath (createTracePath (values, width, height, minValue, maxValue), juce::PathStrokeType (thickness));
+}
+
+juce::Path Analyzer::createTracePath(const std::vector<float>& values, float width, float height, float minValue, float maxValue) const
+{
+    int numFFTPoints = (int) values.size();
+    float nyquist = fs * 0.5f;
+    float minFrequency = 20.0f;
+
+    juce::Path path;
+    path.preallocateSpace (3 * numFFTPoints);
+    bool firstPoint = true;
+
+    for (int i = 0; i < numFFTPoints; ++i)
+    {
+      float freq = (float) i / (float) numFFTPoints * nyquist;
+
+      if (freq < minFrequency)
+          continue;
+
+      auto x = frequencyToX (freq, width);
+      auto y = juce::jmap (juce::jlimit (minValue, maxValue, values[(size_t) i]), minValue, maxValue, height, 0.0f);
+
+      // Path::isEmpty() is still true after just a move, so it can't tell us this
+      if (firstPoint)
+          path.startNewSubPath (x, y);
+      else
+          path.lineTo (x, y);
+
+      firstPoint = false;
+    }
+
+    return path;
+}
+
+void Analyzer::updateReferencePaths(float width, float height, float mindB, float maxdB)
+{
+    auto& references = processorRef.getReferences();
+    auto area = juce::Rectangle<float> (width, height);
+    auto resized = area != referencePathArea;
+    referencePathArea = area;
+
+    for (int s = 0; s < ReferenceSnapshots::numSlots; ++s)
+    {
+      auto version = references.getVersion (s);
+      auto changed = version != referenceVersions[(size_t) s];
+
+      if (changed)
+      {
+          referenceVersions[(size_t) s] = version;
+
+          if (not references.getLevels (s, referenceDb[(size_t) s]))
+              referenceDb[(size_t) s].clear();
+      }
+
+      if (changed || resized)
+          referencePaths[(size_t) s] = referenceDb[(size_t) s].empty()
+                                           ? juce::Path()
+                                           : createTracePath (referenceDb[(size_t) s], width, height, mindB, maxdB);
+    }
+}
+
+void Analyzer::drawReferences(juce::Graphics& g, float width, float height, float mindB, float maxdB)
+{
+    const juce::Colour colours[] = { MyColours::blue, MyColours::red, juce::Colours::orange, juce::Colours::limegreen };
+    static_assert (std::size (colours) == ReferenceSnapshots::numSlots);
+
+    updateReferencePaths (width, height, mindB, maxdB);
+
+    auto& references = processorRef.getReferences();
+    auto legend = juce::Rectangle<float> (width - 130.0f, 4.0f, 126.0f, 14.0f);
+    g.setFont (12.0f);
+
+    for (int s = 0; s < ReferenceSnapshots::numSlots; ++s)
+    {
+      if (referenceDb[(size_t) s].empty())
+          continue;
+
+      g.setColour (colours[s].withAlpha (0.8f));
+      g.strokePath (referencePaths[(size_t) s], juce::PathStrokeType (1.5f));
+
+      g.drawText (references.getName (s) + (s == differenceSlot ? " (diff)" : ""),
+                  legend, juce::Justification::centredRight);
+      legend.translate (0.0f, 14.0f);
+    }
+
+    if (not juce::isPositiveAndBelow (differenceSlot, ReferenceSnapshots::numSlots)
+        || referenceDb[(size_t) differenceSlot].empty())
+      return;
+
+    // The difference moves with every frame, so that one is built fresh each time.
+    // It gets its own +-24 dB scale around a line through the middle.
+    const auto& reference = referenceDb[(size_t) differenceSlot];
+
+    for (size_t n = 0; n < differenceDb.size(); ++n)
+      differenceDb[n] = spectrumDb[n] - reference[n];
+
+    g.setColour (colours[differenceSlot].withAlpha (0.4f));
+    g.drawHorizontalLine (juce::roundToInt (height * 0.5f), 0.0f, width);
+
+    g.setColour (colours[differenceSlot]);
+    drawTrace (g, differenceDb, width, height, -differenceRangeDb, differenceRangeDb, 2.0f);
+}
+
+void Analyzer::storeReference (int slot, const juce::String& name)
+{
+    processorRef.getReferences().store (slot, spectrumDb.data(), name);
+}
+
+void Analyzer::setDifferenceSlot (int slot)
+{
+    differenceSlot = slot;
+    repaint();
+}
+
+void Analyzer::changeListenerCallback (juce::ChangeBroadcaster*)
+{
+    repaint();
+}
+
+float Analyzer::frequencyToX (float freq, float width) const
+{
+    float nyquist = fs * 0.5f;
+    float minFrequency = 20.0f;
+
+    if (freq <= minFrequency)
+      return 0.0f;
+
+    return (std::log(freq) - std::log(minFrequency)) / (std::log(nyquist) - std::log(minFrequency)) * width;
+}
+
+float Analyzer::xToFrequency (float x, float width) const
+{
+    float nyquist = fs * 0.5f;
+    float minFrequency = 20.0f;
+
+    return minFrequency * std::pow(nyquist / minFrequency, juce::jlimit (0.0f, 1.0f, x / width));
+}
+
+juce::String Analyzer::frequencyToText (float freq)
+{
+    if (freq >= 1000.0f)
+      return juce::String (freq * 0.001f, 2) + " kHz";
+
+    return juce::String (freq, 1) + " Hz";
+}
+
+void Analyzer::drawTimeline(juce::Graphics& g, float width)
+{
+    const auto& history = processorRef.getHistory();
+    auto numFrames = history.getNumFrames();
+
+    if (numFrames == 0)
+      return;
+
+    auto newest = history.getFrameTime (numFrames - 1);
+    auto oldest = history.getFrameTime (0);
+    auto viewed = history.getFrameTime (viewedFrame);
+
+    // Strip along the top: the whole history, and where we are in it
+    auto strip = juce::Rectangle<float> (0.0f, 0.0f, width, 6.0f);
+    g.setColour (MyColours::blackGrey);
+    g.fillRect (strip);
+
+    auto proportion = newest > oldest ? (float) ((viewed - oldest) / (newest - oldest)) : 1.0f;
+    g.setColour (MyColours::red);
+    g.fillRect (strip.withWidth (3.0f).withX (proportion * (width - 3.0f)));
+
+    g.setColour (MyColours::cream);
+    g.setFont (12.0f);
+    g.drawText ("Paused  " + juce::String ((viewed - newest) * 0.001, 2) + " s",
+                juce::Rectangle<float> (6.0f, 8.0f, 150.0f, 14.0f), juce::Justification::centredLeft, false);
+}
+
+void Analyzer::setPaused (bool shouldBePaused)
+{
+    paused = shouldBePaused;
+    processorRef.setHistoryFrozen (paused);
+
+    const auto& history = processorRef.getHistory();
+
+    if (paused && history.getNumFrames() > 0)
+      viewFrame (history.getNumFrames() - 1);
+
+    repaint();
+}
+
+void Analyzer::viewFrame (int index)
+{
+    const auto& history = processorRef.getHistory();
+
+    if (history.getNumFrames() == 0)
+      return;
+
+    viewedFrame = juce::jlimit (0, history.getNumFrames() - 1, index);
+    history.decode (viewedFrame, spectrumDb.data());
+    repaint();
+}
+
+void Analyzer::mouseDown (const juce::MouseEvent& e)
+{
+    mouseDrag (e);
+}
+
+void Analyzer::mouseDrag (const juce::MouseEvent& e)
+{
+    // Dragging across the display scrubs through the whole history
+    if (paused && getWidth() > 0)
+      viewFrame (juce::roundToInt (e.position.x / (float) getWidth() * (float) (processorRef.getHistory().getNumFrames() - 1)));
+}
+
+void Analyzer::mouseWheelMove (const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel)
+{
+    juce::ignoreUnused (e);
+
+    // The wheel steps one frame at a time
+    if (paused && wheel.deltaY != 0.0f)
+      viewFrame (viewedFrame + (wheel.deltaY > 0.0f ? 1 : -1));
+}
+
+void Analyzer::mouseMove (const juce::MouseEvent& e)
+{
+    mousePosition = e.position;
+    repaint();
+}
+
+void Analyzer::mouseExit (const juce::MouseEvent& e)
+{
+    juce::ignoreUnused (e);
+    mousePosition.reset();
+    repaint();
 }
 
 void Analyzer::timerCallback()
 {
+    // A pending delay search gets finished here on the message thread
+    processorRef.updateSidechainDelay();
+
     if (processorRef.nextFFTBlockReady.get())
     {
-      drawNextFrameOfSpectrum();
+      // While paused, keep taking frames so the processor carries on, but leave the display alone
+      if (not paused)
+      {
+          drawNextFrameOfSpectrum();
+          repaint();
+      }
+
       processorRef.nextFFTBlockReady.set(false);
+    }
+    else if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::tracker && not paused)
+    {
+      // There are no FFT frames to wait for in tracker mode
       repaint();
     }
+
+    // The lanes' workers only wake when told a frame is waiting
+    if (processorRef.getDisplayMode() == PluginProcessor::DisplayMode::channels)
+      processorRef.getMultichannelAnalyzer().service();
 }
 
 
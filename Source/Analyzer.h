@@ -11,6 +11,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PeakDetector.h"
+#include "LevelMeter.h"
+#include "LevelOfDetail.h"
+#include "ReferenceSnapshots.h"
+#include "BandAnalyzer.h"
+#include "OnsetDetector.h"
+#include "HarmonicAnalyzer.h"
+#include "SpectrumPercentiles.h"
+#include "ReassignedSpectrogram.h"
 
 //==============================================================================
 /*
@@ -19,7 +28,8 @@
 class PluginProcessor; // Forward declaration
 
 class Analyzer  : public juce::Component,
-                  public juce::Timer
+                  public juce::Timer,
+                  private juce::ChangeListener
 {
 public:
     explicit Analyzer(PluginProcessor&, double);
@@ -29,12 +39,49 @@ public:
     void resized() override;
     void timerCallback() override;
 
+    void mouseMove (const juce::MouseEvent& e) override;
+    void mouseExit (const juce::MouseEvent& e) override;
+    void mouseDown (const juce::MouseEvent& e) override;
+    void mouseDrag (const juce::MouseEvent& e) override;
+    void mouseWheelMove (const juce::MouseEvent& e, const juce::MouseWheelDetails& wheel) override;
+
+    // Freezes the display so the history can be scrubbed through
+    void setPaused (bool shouldBePaused);
+    bool isPaused() const { return paused; }
+
+    // Freezes the spectrum on display, live or from the history, into a reference slot
+    void storeReference (int slot, const juce::String& name);
+
+    // Draws live minus this reference slot, -1 for none
+    void setDifferenceSlot (int slot);
+
     void drawNextFrameOfSpectrum();
     void drawGrid(juce::Graphics& g, float width, float height, float mindB, float maxdB);
     void drawSpectrum(juce::Graphics& g, float width, float height, float mindB, float maxdB);
     void drawOutline(juce::Graphics& g, float width, float height, float mindB, float maxdB);
     static void drawVerticalLineForFrequency(juce::Graphics& g, float freq, float level, int width, int height, float nyquist, float minFrequency, float lineThickness);
     void drawFrame (juce::Graphics& g);
+    void drawPeaks(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawHoverReadout(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawTransferFunction(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawPhaseLane(juce::Graphics& g, juce::Rectangle<float> area);
+    void drawLevelMeters(juce::Graphics& g, juce::Rectangle<float> area);
+    void drawTimeline(juce::Graphics& g, float width);
+    void drawTrace(juce::Graphics& g, const std::vector<float>& values, float width, float height, float minValue, float maxValue, float thickness);
+    void drawReferences(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawBands(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawOnsets(juce::Graphics& g, float width);
+    void drawHarmonics(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawTracker(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawChannelLanes(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawPercentiles(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawNoiseFloor(juce::Graphics& g, float width, float height, float mindB, float maxdB);
+    void drawSpectrogram(juce::Graphics& g, float width, float height);
+    juce::Path createTracePath(const std::vector<float>& values, float width, float height, float minValue, float maxValue) const;
+
+    float frequencyToX (float freq, float width) const;
+    float xToFrequency (float x, float width) const;
+    static juce::String frequencyToText (float freq);
 
 private:
     PluginProcessor& processorRef;
@@ -43,5 +90,84 @@ private:
     int scopeSize;
     std::vector<float> scopeData;
 
+    // Copied from the processor along with each new frame
+    PeakDetector::Result peaks;
+    std::vector<float> transferMagnitude;
+    std::vector<float> transferPhase;
+    std::vector<float> coherence;
+    std::vector<float> stereoCorrelation;
+    std::vector<float> stereoPhase;
+    float broadbandCorrelation = 0.0f;
+    LevelMeter::Readings levels;
+    BandAnalyzer::Result bands;
+    HarmonicAnalyzer::Result harmonics;
+    SpectrumPercentiles::Result percentiles;
+
+    // The percentile levels again, as traces forEachPoint can walk, and their
+    // points on screen. Kept between paints so they're only allocated once.
+    std::array<std::vector<float>, SpectrumPercentiles::numPercentiles> percentileDb;
+    std::array<std::vector<juce::Point<float>>, SpectrumPercentiles::numPercentiles> percentilePoints;
+
+    // Tracker levels are read straight from the processor at every repaint
+    static constexpr double trackerSeconds = 2.0;
+    std::vector<float> trackerDb;
+
+    // One spectrum per input channel for the lanes, and the channels' short names
+    std::vector<std::vector<float>> channelDb;
+    juce::StringArray channelNames;
+
+    // Reassigned spectrogram, a ring of rows with the newest at the top. Each
+    // frame only writes its own rows, the image is never redrawn as a whole.
+    static constexpr int spectrogramRows = 1024;
+    static constexpr float spectrogramMinDb = -100.0f;
+    static constexpr float spectrogramFadeDb = 0.75f; // Per row, so a steady tone reads as a line between frames
+    juce::Image spectrogramImage;
+    int spectrogramRow = 0;
+    std::array<float, ReassignedSpectrogram::numCells> spectrogramTrailDb;
+    std::array<juce::Colour, 256> spectrogramColours;
+    void addSpectrogramRows (const ReassignedSpectrogram::Result& slices);
+
+    // Onsets of the last few seconds, scrolling along the top. Positions are input samples.
+    static constexpr double onsetLaneSeconds = 4.0;
+    static constexpr size_t maxRecentOnsets = 64;
+    std::vector<OnsetDetector::Result> recentOnsets;
+    juce::int64 latestFrameEnd = 0;
+
+    // Levels of the frame on display, in dB relative to full scale
+    std::vector<float> spectrumDb;
+    std::vector<float> outlineDb;
+    std::vector<float> floorDb;
+
+    // The floor's points on screen and their levels, kept between paints
+    std::vector<juce::Point<float>> floorPoints;
+    std::vector<float> floorLevels;
+
+    // Paused, the display shows a frame of the processor's history
+    bool paused = false;
+    int viewedFrame = 0;
+
+    std::optional<juce::Point<float>> mousePosition;
+
+    // Reference traces. Their paths only change when a slot does or the drawing area resizes.
+    static constexpr float differenceRangeDb = 24.0f;
+    std::array<std::vector<float>, ReferenceSnapshots::numSlots> referenceDb;
+    std::array<juce::Path, ReferenceSnapshots::numSlots> referencePaths;
+    std::array<int, ReferenceSnapshots::numSlots> referenceVersions;
+    juce::Rectangle<float> referencePathArea;
+    std::vector<float> differenceDb;
+    int differenceSlot = -1;
+
+    void updateReferencePaths (float width, float height, float mindB, float maxdB);
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
+
+    void viewFrame (int index);
+
+    // Keeps the drawing inside its budget however big the window gets
+    LevelOfDetail detail;
+    void updateRepaintRate();
+
+    template <typename Callback>
+    void forEachPoint (const std::vector<float>& levelsDb, float width, Callback&& callback) const;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Analyzer)
 };
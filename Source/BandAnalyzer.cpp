@@ -0,0 +1,297 @@
+/*
+==============================================================================
+
+    BandAnalyzer.cpp
+    Created: 19 Oct 2026 4:20:23am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "BandAnalyzer.h"
+
+#include <complex>
+
+// Base-10 octave ratio from IEC 61260
+static const double octaveRatio = std::pow (10.0, 0.3);
+
+// Equivalent noise bandwidth of the Hann window in bins. Dividing the summed
+// bin power by it makes a sine read the same as its peak on the spectrum.
+static constexpr float hannNoiseBandwidth = 1.5f;
+
+static constexpr double holdSeconds = 2.0;
+static constexpr float fallDbPerSecond = 12.0f;
+static constexpr float floorDb = -200.0f;
+
+//==============================================================================
+BandAnalyzer::BandAnalyzer (int size)
+    : fftSize (size)
+{
+    peakDb.fill (floorDb);
+}
+
+void BandAnalyzer::prepare (double sampleRate)
+{
+    fs = sampleRate;
+
+    // 20 Hz to 20 kHz in thirds, 31.5 Hz to 16 kHz in octaves
+    buildBandSet (bandSets[(size_t) Resolution::thirdOctave], 3, -17, 13);
+    buildBandSet (bandSets[(size_t) Resolution::octave], 1, -5, 4);
+
+    resolution = requestedResolution.load();
+    bands = &bandSets[(size_t) resolution];
+    filterbankActive = useFilterbank.load();
+    weightingVersion = -1;
+    clearState();
+}
+
+void BandAnalyzer::setResolution (Resolution newResolution)
+{
+    requestedResolution = newResolution;
+}
+
+void BandAnalyzer::setUseFilterbank (bool shouldUseFilterbank)
+{
+    useFilterbank = shouldUseFilterbank;
+}
+
+void BandAnalyzer::setWeighting (SpectrumWeighting::Curve newCurve, float newTiltDbPerOctave)
+{
+    requestedCurve = newCurve;
+    requestedTilt = newTiltDbPerOctave;
+    ++requestedWeightingVersion;
+}
+
+void BandAnalyzer::applySettings()
+{
+    if (weightingVersion != requestedWeightingVersion.load())
+    {
+        weightingVersion = requestedWeightingVersion.load();
+        auto curve = requestedCurve.load();
+        auto tilt = requestedTilt.load();
+
+        for (auto& set : bandSets)
+            for (int b = 0; b < set.numBands; ++b)
+            {
+                auto centre = std::sqrt ((double) set.lower[(size_t) b] * (double) set.upper[(size_t) b]);
+                set.weightingGains[(size_t) b] = juce::Decibels::decibelsToGain (SpectrumWeighting::getGainDb (curve, tilt, centre), -1000.0f);
+                set.weightingGains[(size_t) b] *= set.weightingGains[(size_t) b];
+            }
+    }
+
+    auto newResolution = requestedResolution.load();
+    auto newFilterbank = useFilterbank.load();
+
+    if (newResolution == resolution && newFilterbank == filterbankActive)
+        return;
+
+    resolution = newResolution;
+    filterbankActive = newFilterbank;
+    bands = &bandSets[(size_t) resolution];
+    clearState();
+}
+
+void BandAnalyzer::clearState()
+{
+    for (auto& set : bandSets)
+        for (auto& filter : set.filters)
+            filter.z1 = filter.z2 = 0.0;
+
+    filterEnergy.fill (0.0);
+    filterSamples = 0;
+    power.fill (0.0f);
+    peakDb.fill (floorDb);
+    peakAge.fill (0);
+}
+
+//==============================================================================
+void BandAnalyzer::buildBandSet (BandSet& set, int bandsPerOctave, int firstIndex, int lastIndex)
+{
+    auto nyquist = fs * 0.5;
+    auto binWidth = fs / (double) fftSize;
+    auto edgeRatio = std::pow (octaveRatio, 0.5 / (double) bandsPerOctave);
+
+    set.numBands = 0;
+    set.offsets.clear();
+    set.bins.clear();
+    set.weights.clear();
+    set.offsets.push_back (0);
+
+    for (int x = firstIndex; x <= lastIndex && set.numBands < maxBands; ++x)
+    {
+        auto centre = 1000.0 * std::pow (octaveRatio, (double) x / (double) bandsPerOctave);
+        auto lower = centre / edgeRatio;
+        auto upper = centre * edgeRatio;
+
+        // Leave out bands the filters can't get anywhere near at this rate
+        if (upper >= nyquist * 0.95)
+            break;
+
+        auto b = set.numBands++;
+        set.lower[(size_t) b] = (float) lower;
+        set.upper[(size_t) b] = (float) upper;
+
+        // Bin k covers (k - 0.5) to (k + 0.5) bin widths, weight it by how much of that is in the band
+        auto firstBin = juce::jmax (1, (int) std::floor (lower / binWidth + 0.5));
+        auto lastBin = juce::jmin (fftSize / 2 - 1, (int) std::ceil (upper / binWidth - 0.5));
+
+        for (int k = firstBin; k <= lastBin; ++k)
+        {
+            auto overlap = juce::jmin (upper, (k + 0.5) * binWidth) - juce::jmax (lower, (k - 0.5) * binWidth);
+
+            if (overlap > 0.0)
+            {
+                set.bins.push_back (k);
+                set.weights.push_back ((float) (overlap / binWidth));
+            }
+        }
+
+        set.offsets.push_back ((int) set.bins.size());
+
+        designBandPass (lower, upper, fs, set.filters.data() + b * sectionsPerBand);
+    }
+}
+
+void BandAnalyzer::designBandPass (double lowerFrequency, double upperFrequency, double sampleRate, Biquad* sections)
+{
+    const auto pi = juce::MathConstants<double>::pi;
+
+    // Pre-warped edges, so the bilinear transform puts them where they belong
+    auto prewarp = [sampleRate, pi] (double f) { return 2.0 * sampleRate * std::tan (pi * f / sampleRate); };
+    auto w1 = prewarp (lowerFrequency);
+    auto w2 = prewarp (upperFrequency);
+    auto centreSquared = w1 * w2;
+    auto bandwidth = w2 - w1;
+
+    // 3rd-order Butterworth low-pass prototype, turned into a band-pass: every
+    // prototype pole becomes two. One of each conjugate pair makes a section.
+    int numSections = 0;
+
+    for (int k = 0; k < 3; ++k)
+    {
+        auto pole = std::polar (1.0, pi * (double) (2 * k + 4) / 6.0);
+        auto half = pole * bandwidth * 0.5;
+        auto root = std::sqrt (half * half - centreSquared);
+
+        for (auto s : { half + root, half - root })
+        {
+            if (s.imag() <= 0.0 || numSections == sectionsPerBand)
+                continue;
+
+            auto z = (2.0 * sampleRate + s) / (2.0 * sampleRate - s);
+
+            // Zeros at DC and Nyquist, which is where the band-pass puts them
+            auto& section = sections[numSections++];
+            section = {};
+            section.b0 = 1.0;
+            section.b1 = 0.0;
+            section.b2 = -1.0;
+            section.a1 = -2.0 * z.real();
+            section.a2 = std::norm (z);
+        }
+    }
+
+    jassert (numSections == sectionsPerBand);
+
+    // Unity gain at the centre, section by section
+    auto centre = 2.0 * std::atan (std::sqrt (centreSquared) / (2.0 * sampleRate));
+    auto e = std::polar (1.0, -centre);
+
+    for (int i = 0; i < numSections; ++i)
+    {
+        auto& section = sections[i];
+        auto response = (section.b0 + section.b1 * e + section.b2 * e * e) / (1.0 + section.a1 * e + section.a2 * e * e);
+        auto scale = 1.0 / std::abs (response);
+
+        section.b0 *= scale;
+        section.b1 *= scale;
+        section.b2 *= scale;
+    }
+}
+
+//==============================================================================
+void BandAnalyzer::processSamples (const float* samples, int numSamples)
+{
+    applySettings();
+
+    if (not filterbankActive)
+        return;
+
+    for (int b = 0; b < bands->numBands; ++b)
+    {
+        auto* sections = bands->filters.data() + b * sectionsPerBand;
+        auto energy = 0.0;
+
+        for (int n = 0; n < numSamples; ++n)
+        {
+            auto y = sections[2].process (sections[1].process (sections[0].process ((double) samples[n])));
+            energy += y * y;
+        }
+
+        filterEnergy[(size_t) b] += energy;
+    }
+
+    filterSamples += numSamples;
+}
+
+void BandAnalyzer::processFrame (const float* magnitudes, float leak, Result& result)
+{
+    applySettings();
+
+    const auto& set = *bands;
+    auto binScale = 1.0f / ((float) fftSize * (float) fftSize * hannNoiseBandwidth);
+
+    // The FFT reads a sine at half its amplitude, so halve the filterbank's mean square to match
+    auto filterScale = filterSamples > 0 ? 0.5 / (double) filterSamples : 0.0;
+
+    auto frameSeconds = (double) fftSize / fs;
+    auto holdFrames = (int) std::ceil (holdSeconds / frameSeconds);
+    auto fall = (float) (fallDbPerSecond * frameSeconds);
+
+    for (int b = 0; b < set.numBands; ++b)
+    {
+        float bandPower;
+
+        if (filterbankActive)
+        {
+            bandPower = (float) (filterEnergy[(size_t) b] * filterScale) * set.weightingGains[(size_t) b];
+            filterEnergy[(size_t) b] = 0.0;
+        }
+        else
+        {
+            bandPower = 0.0f;
+
+            for (int i = set.offsets[(size_t) b]; i < set.offsets[(size_t) b + 1]; ++i)
+            {
+                auto m = magnitudes[set.bins[(size_t) i]];
+                bandPower += set.weights[(size_t) i] * m * m;
+            }
+
+            bandPower *= binScale;
+        }
+
+        // Same time constant as the spectrum smoothing, but on power
+        auto& p = power[(size_t) b];
+        p = leak * p + (1.0f - leak) * bandPower;
+
+        auto levelDb = p > 0.0f ? 10.0f * std::log10 (p) : floorDb;
+
+        if (levelDb >= peakDb[(size_t) b])
+        {
+            peakDb[(size_t) b] = levelDb;
+            peakAge[(size_t) b] = 0;
+        }
+        else if (++peakAge[(size_t) b] > holdFrames)
+        {
+            peakDb[(size_t) b] = juce::jmax (levelDb, peakDb[(size_t) b] - fall);
+        }
+
+        result.lowerFrequency[(size_t) b] = set.lower[(size_t) b];
+        result.upperFrequency[(size_t) b] = set.upper[(size_t) b];
+        result.levelDb[(size_t) b] = levelDb;
+        result.peakDb[(size_t) b] = peakDb[(size_t) b];
+    }
+
+    result.numBands = set.numBands;
+    filterSamples = 0;
+}
@@ -0,0 +1,134 @@
+/*
+==============================================================================
+
+    BandAnalyzer.h
+    Created: 19 Oct 2026 4:20:23am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SpectrumWeighting.h"
+
+//==============================================================================
+/*
+    1/1 and 1/3-octave band levels for the RTA display, on the IEC 61260
+    base-10 band centres.
+
+    By default each band's power is summed from the FFT bins with a
+    precomputed weight per bin: the share of the bin's width that falls inside
+    the band. That's cheap, but below a few hundred Hz the bins are wider
+    than the bands. The optional filterbank runs a 6th-order Butterworth
+    band-pass per band on every input sample instead. That's more CPU, but the
+    band shapes are right all the way down.
+
+    Levels are on the same scale as the spectrum display, so a sine reads the
+    same in both. So is the weighting: the bins come in already weighted, and
+    the filterbank bands take the weighting's gain at their centres. The peak
+    of each band is held for two seconds and then falls at 12 dB/s.
+
+    The tables and filters for both resolutions are built in prepare(), so
+    switching between them on the audio thread never allocates.
+*/
+
+class BandAnalyzer
+{
+public:
+    enum class Resolution
+    {
+        thirdOctave = 0,
+        octave
+    };
+
+    static constexpr int maxBands = 31;
+
+    struct Result
+    {
+        int numBands = 0;
+        std::array<float, maxBands> lowerFrequency {};
+        std::array<float, maxBands> upperFrequency {};
+        std::array<float, maxBands> levelDb {};
+        std::array<float, maxBands> peakDb {};
+    };
+
+    explicit BandAnalyzer (int fftSize);
+
+    void prepare (double sampleRate);
+
+    // Any thread, picked up on the next block or frame
+    void setResolution (Resolution newResolution);
+    void setUseFilterbank (bool shouldUseFilterbank);
+    bool isUsingFilterbank() const { return useFilterbank.load(); }
+    void setWeighting (SpectrumWeighting::Curve newCurve, float newTiltDbPerOctave);
+
+    // Audio thread. Feeds the filterbank, only needed while it's in use.
+    void processSamples (const float* samples, int numSamples);
+
+    // Audio thread, once per FFT frame. magnitudes holds fftSize / 2 bins.
+    void processFrame (const float* magnitudes, float leak, Result& result);
+
+private:
+    struct Biquad
+    {
+        double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double z1 = 0.0, z2 = 0.0;
+
+        double process (double x) noexcept
+        {
+            auto y = b0 * x + z1;
+            z1 = b1 * x - a1 * y + z2;
+            z2 = b2 * x - a2 * y;
+            return y;
+        }
+    };
+
+    static constexpr int sectionsPerBand = 3;
+
+    struct BandSet
+    {
+        int numBands = 0;
+        std::array<float, maxBands> lower {}, upper {};
+
+        // Bins and weights of band b are entries offsets[b] to offsets[b + 1]
+        std::vector<int> offsets, bins;
+        std::vector<float> weights;
+
+        std::array<Biquad, maxBands * sectionsPerBand> filters;
+
+        // Weighting and tilt at each band's centre, as power, for the filterbank
+        std::array<float, maxBands> weightingGains {};
+    };
+
+    void buildBandSet (BandSet& set, int bandsPerOctave, int firstIndex, int lastIndex);
+    static void designBandPass (double lowerFrequency, double upperFrequency, double sampleRate, Biquad* sections);
+    void applySettings();
+    void clearState();
+
+    const int fftSize;
+    double fs = 44100.0;
+
+    std::array<BandSet, 2> bandSets;
+    BandSet* bands = &bandSets[0];
+
+    std::atomic<Resolution> requestedResolution { Resolution::thirdOctave };
+    std::atomic<bool> useFilterbank { false };
+    Resolution resolution = Resolution::thirdOctave;
+    bool filterbankActive = false;
+
+    std::atomic<SpectrumWeighting::Curve> requestedCurve { SpectrumWeighting::Curve::z };
+    std::atomic<float> requestedTilt { 0.0f };
+    std::atomic<int> requestedWeightingVersion { 0 };
+    int weightingVersion = -1;
+
+    // Per band: filterbank energy since the last frame, smoothed power, peak hold
+    std::array<double, maxBands> filterEnergy {};
+    int filterSamples = 0;
+    std::array<float, maxBands> power {};
+    std::array<float, maxBands> peakDb {};
+    std::array<int, maxBands> peakAge {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BandAnalyzer)
+};
@@ -0,0 +1,320 @@
+/*
+==============================================================================
+
+    CaptureRecorder.cpp
+    Created: 19 Oct 2026 4:48:23am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "CaptureRecorder.h"
+
+// Ring beyond the longest capture, the writer's head start on the audio thread
+static constexpr double headroomSeconds = 5.0;
+
+// Samples copied out of the ring and written at a time
+static constexpr int chunkSize = 8192;
+
+// How often the writer looks for a capture, and how long it waits for samples that
+// are still to come before giving up on them, say when the transport has stopped
+static constexpr int pollMilliseconds = 50;
+static constexpr int stalledMilliseconds = 2000;
+
+//==============================================================================
+class CaptureRecorder::Writer  : public juce::Thread
+{
+public:
+    explicit Writer (CaptureRecorder& o)
+        : juce::Thread ("Capture writer"),
+          owner (o),
+          chunk (juce::jmax (1, o.numChannels), chunkSize)
+    {
+    }
+
+    void run() override
+    {
+        while (not threadShouldExit())
+        {
+            wait (pollMilliseconds);
+
+            auto end = owner.pendingEnd.exchange (-1);
+
+            if (end < 0)
+                continue;
+
+            owner.writeCapture (end, *this);
+            owner.writing = false;
+            owner.sendChangeMessage();
+        }
+    }
+
+    // Where the ring is copied to on its way to the file
+    juce::AudioBuffer<float> chunk;
+
+private:
+    CaptureRecorder& owner;
+};
+
+//==============================================================================
+CaptureRecorder::CaptureRecorder()
+    : directory (juce::File::getSpecialLocation (juce::File::userDocumentsDirectory))
+{
+}
+
+CaptureRecorder::~CaptureRecorder()
+{
+    release();
+}
+
+void CaptureRecorder::prepare (double newSampleRate, int newNumChannels, int newMaxBlockSize)
+{
+    release();
+
+    sampleRate = newSampleRate;
+    numChannels = juce::jmax (0, newNumChannels);
+    maxBlockSize = juce::jmax (1, newMaxBlockSize);
+    ringLength = (int) std::ceil ((maxSeconds + headroomSeconds) * sampleRate);
+
+    ring.assign ((size_t) numChannels * (size_t) ringLength, 0.0f);
+    written = 0;
+    pendingEnd = -1;
+    writing = false;
+    aboveThreshold = false;
+
+    if (numChannels == 0)
+        return;
+
+    writerThread = std::make_unique<Writer> (*this);
+    writerThread->startThread();
+}
+
+void CaptureRecorder::release()
+{
+    if (writerThread != nullptr)
+    {
+        writerThread->signalThreadShouldExit();
+        writerThread->notify();
+        writerThread->stopThread (4000);
+        writerThread.reset();
+    }
+
+    writing = false;
+}
+
+void CaptureRecorder::setSeconds (double newSeconds)
+{
+    seconds = juce::jlimit (0.1, maxSeconds, newSeconds);
+}
+
+void CaptureRecorder::setTrigger (Trigger newTrigger)
+{
+    triggerMode = newTrigger;
+}
+
+void CaptureRecorder::setThresholdDb (float newThresholdDb)
+{
+    threshold = juce::Decibels::decibelsToGain (newThresholdDb);
+}
+
+void CaptureRecorder::setDirectory (const juce::File& newDirectory)
+{
+    const juce::ScopedLock sl (lock);
+    directory = newDirectory;
+}
+
+juce::File CaptureRecorder::getLastFile() const
+{
+    const juce::ScopedLock sl (lock);
+    return lastFile;
+}
+
+juce::String CaptureRecorder::getLastError() const
+{
+    const juce::ScopedLock sl (lock);
+    return lastError;
+}
+
+void CaptureRecorder::push (const float* const* channels, int numInputChannels, int numSamples) noexcept
+{
+    if (numChannels == 0 || numSamples <= 0)
+        return;
+
+    auto start = written.load (std::memory_order_relaxed);
+    auto position = (int) (start % ringLength);
+
+    // In pieces no longer than maxBlockSize, split at the wrap, each published
+    // once it's in. That's as far ahead of written as the writer has to stay,
+    // whatever size of block the host sends.
+    for (int done = 0; done < numSamples;)
+    {
+        auto numToCopy = juce::jmin (numSamples - done, ringLength - position, maxBlockSize);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            auto* destination = ring.data() + (size_t) c * (size_t) ringLength + (size_t) position;
+
+            if (c < numInputChannels)
+                std::copy (channels[c] + done, channels[c] + done + numToCopy, destination);
+            else
+                std::fill (destination, destination + numToCopy, 0.0f);
+        }
+
+        done += numToCopy;
+        position = (position + numToCopy) % ringLength;
+        written.store (start + done, std::memory_order_release);
+    }
+
+    if (triggerMode.load() != Trigger::level)
+        return;
+
+    auto peak = 0.0f;
+
+    for (int c = 0; c < juce::jmin (numChannels, numInputChannels); ++c)
+    {
+        auto range = juce::FloatVectorOperations::findMinAndMax (channels[c], numSamples);
+        peak = juce::jmax (peak, -range.getStart(), range.getEnd());
+    }
+
+    auto wasAbove = std::exchange (aboveThreshold, peak >= threshold.load());
+
+    if (aboveThreshold && not wasAbove)
+        trigger (start);
+}
+
+void CaptureRecorder::onsetAt (juce::int64 sample) noexcept
+{
+    if (triggerMode.load() == Trigger::onset)
+        trigger (sample);
+}
+
+void CaptureRecorder::capture() noexcept
+{
+    if (numChannels == 0)
+        return;
+
+    auto end = written.load();
+    auto expected = (juce::int64) -1;
+
+    // The writer finds it next time it looks
+    if (not writing.load())
+        pendingEnd.compare_exchange_strong (expected, end);
+}
+
+void CaptureRecorder::trigger (juce::int64 sample) noexcept
+{
+    // Half before and half after. One capture at a time, triggers while it's
+    // being written are ignored.
+    auto end = sample + (juce::int64) (0.5 * seconds.load() * sampleRate);
+    auto expected = (juce::int64) -1;
+
+    if (not writing.load())
+        pendingEnd.compare_exchange_strong (expected, end);
+}
+
+void CaptureRecorder::writeCapture (juce::int64 end, Writer& thread)
+{
+    writing = true;
+
+    auto fail = [this] (const juce::String& error)
+    {
+        const juce::ScopedLock sl (lock);
+        lastError = error;
+    };
+
+    juce::File folder;
+
+    {
+        const juce::ScopedLock sl (lock);
+        folder = directory;
+    }
+
+    if (not folder.createDirectory())
+    {
+        fail ("Can't create " + folder.getFullPathName());
+        return;
+    }
+
+    auto file = folder.getChildFile ("Capture " + juce::Time::getCurrentTime().formatted ("%Y-%m-%d %H-%M-%S") + ".wav")
+                      .getNonexistentSibling();
+
+    auto stream = file.createOutputStream();
+
+    if (stream == nullptr || stream->failedToOpen())
+    {
+        fail ("Can't write " + file.getFullPathName());
+        return;
+    }
+
+    // Float, so whatever went through the analyzer comes back exactly, overs included
+    juce::WavAudioFormat format;
+    std::unique_ptr<juce::AudioFormatWriter> writer (format.createWriterFor (stream.get(), sampleRate, (unsigned int) numChannels,
+                                                                             32, {}, 0));
+
+    if (writer == nullptr)
+    {
+        fail ("Can't write " + file.getFullPathName());
+        return;
+    }
+
+    stream.release(); // The writer owns it now
+
+    // Only what's still in the ring and clear of the piece being pushed, from the oldest sample on
+    auto start = juce::jmax ((juce::int64) 0,
+                             end - (juce::int64) (seconds.load() * sampleRate),
+                             written.load() + maxBlockSize - ringLength);
+
+    auto& chunk = thread.chunk;
+    auto lastProgress = juce::Time::getMillisecondCounter();
+    juce::String error;
+
+    for (auto position = start; position < end && not thread.threadShouldExit();)
+    {
+        auto available = written.load (std::memory_order_acquire);
+
+        if (available <= position)
+        {
+            if (juce::Time::getMillisecondCounter() - lastProgress > (juce::uint32) stalledMilliseconds)
+                break;
+
+            juce::Thread::sleep (pollMilliseconds);
+            continue;
+        }
+
+        auto numToCopy = (int) juce::jmin ((juce::int64) chunkSize, end - position, available - position);
+        auto ringPosition = (int) (position % ringLength);
+        auto firstPart = juce::jmin (numToCopy, ringLength - ringPosition);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const auto* row = ring.data() + (size_t) c * (size_t) ringLength;
+            chunk.copyFrom (c, 0, row + ringPosition, firstPart);
+
+            if (firstPart < numToCopy)
+                chunk.copyFrom (c, firstPart, row, numToCopy - firstPart);
+        }
+
+        // The audio thread may have come round again while we were copying. The
+        // piece after what's published may already be going in, so that counts too.
+        if (written.load (std::memory_order_acquire) + maxBlockSize - ringLength > position)
+        {
+            error = "The disk fell behind, the capture was cut short";
+            break;
+        }
+
+        if (not writer->writeFromAudioSampleBuffer (chunk, 0, numToCopy))
+        {
+            error = "Can't write " + file.getFullPathName();
+            break;
+        }
+
+        position += numToCopy;
+        lastProgress = juce::Time::getMillisecondCounter();
+    }
+
+    writer.reset();
+
+    const juce::ScopedLock sl (lock);
+    lastFile = file;
+    lastError = error;
+}
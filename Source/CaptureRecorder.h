@@ -0,0 +1,115 @@
+/*
+==============================================================================
+
+    CaptureRecorder.h
+    Created: 19 Oct 2026 4:48:23am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Keeps the last half minute of the analysed input, so the audio behind
+    something odd on the display can be saved to a WAV file and replayed.
+
+    The audio thread copies every block into a ring that is allocated up
+    front, then publishes how far it has written. That's all it does: a
+    capture, whether asked for or fired by the level or an onset, is only a
+    sample position left in an atomic. A writer thread polls for it, copies
+    the ring out in chunks and streams them to disk, so nothing the disk does
+    can hold up processBlock.
+
+    The ring is longer than the longest capture, and the writer starts from
+    the oldest samples, so it has a few seconds' head start on the audio
+    thread coming round again. If the disk stalls for longer than that the
+    file is cut short where the samples were overwritten. The audio thread
+    publishes at least every maxBlockSize samples, so the writer keeps that
+    far clear of what's published, as it may already be being overwritten.
+    Automatic captures take half their length from after the trigger, which
+    the writer waits for.
+*/
+
+class CaptureRecorder  : public juce::ChangeBroadcaster
+{
+public:
+    static constexpr double maxSeconds = 30.0;
+
+    enum class Trigger
+    {
+        manual = 0,
+        level,
+        onset
+    };
+
+    CaptureRecorder();
+    ~CaptureRecorder() override;
+
+    // Not the audio thread: allocates the ring and starts the writer
+    void prepare (double sampleRate, int numChannels, int maxBlockSize);
+    void release();
+
+    // Any thread
+    void setSeconds (double newSeconds);
+    void setTrigger (Trigger newTrigger);
+    void setThresholdDb (float newThresholdDb);
+
+    // Message thread. Captures go in here, one file each.
+    void setDirectory (const juce::File& newDirectory);
+
+    // Audio thread, every block, all of it
+    void push (const float* const* channels, int numInputChannels, int numSamples) noexcept;
+
+    // Audio thread, for an onset at this input sample when the trigger is onset
+    void onsetAt (juce::int64 sample) noexcept;
+
+    // Any thread. Saves the last getSeconds() of input up to now.
+    void capture() noexcept;
+
+    // Message thread. Whoever's listening is told when a capture has been
+    // written, or has failed.
+    juce::File getLastFile() const;
+    juce::String getLastError() const;
+    bool isWriting() const noexcept { return writing.load(); }
+
+private:
+    class Writer;
+
+    void trigger (juce::int64 endSample) noexcept;
+    void writeCapture (juce::int64 endSample, Writer& thread);
+
+    double sampleRate = 44100.0;
+    int numChannels = 0;
+    int ringLength = 0;
+    int maxBlockSize = 0;
+
+    // numChannels rows of ringLength samples
+    std::vector<float> ring;
+
+    // Samples pushed since prepare, published after they're in the ring
+    std::atomic<juce::int64> written { 0 };
+
+    // Where the next capture ends, or -1
+    std::atomic<juce::int64> pendingEnd { -1 };
+    std::atomic<bool> writing { false };
+
+    std::atomic<double> seconds { 10.0 };
+    std::atomic<Trigger> triggerMode { Trigger::manual };
+    std::atomic<float> threshold { 0.5f };
+
+    // Level triggers don't fire again until the level has dropped back below the threshold
+    bool aboveThreshold = false;
+
+    mutable juce::CriticalSection lock;
+    juce::File directory;
+    juce::File lastFile;
+    juce::String lastError;
+
+    std::unique_ptr<Writer> writerThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CaptureRecorder)
+};
@@ -0,0 +1,160 @@
+/*
+==============================================================================
+
+    HarmonicAnalyzer.cpp
+    Created: 19 Oct 2026 4:24:52am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "HarmonicAnalyzer.h"
+
+// The audio band THD+N and SNR are measured over
+static constexpr double lowestFrequency = 20.0;
+static constexpr double highestFrequency = 20000.0;
+
+static constexpr float floorPower = 1.0e-30f;
+
+//==============================================================================
+HarmonicAnalyzer::HarmonicAnalyzer (int size)
+    : fftSize (size),
+      numBins (size / 2),
+      averagedPower ((size_t) size / 2, 0.0f)
+{
+    using WindowingFunction = juce::dsp::WindowingFunction<float>;
+
+    // Same tables as the pipeline, only needed for their noise bandwidths
+    const std::array<WindowingFunction::WindowingMethod, AnalysisPipeline::numWindows> methods
+        { WindowingFunction::hann, WindowingFunction::blackmanHarris, WindowingFunction::flatTop };
+
+    std::vector<float> table ((size_t) size);
+
+    for (size_t w = 0; w < methods.size(); ++w)
+    {
+        WindowingFunction::fillWindowingTables (table.data(), (size_t) size, methods[w], true);
+
+        double sum = 0.0, sumOfSquares = 0.0;
+
+        for (auto value : table)
+        {
+            sum += value;
+            sumOfSquares += (double) value * value;
+        }
+
+        noiseBandwidths[w] = (float) ((double) size * sumOfSquares / (sum * sum));
+    }
+}
+
+void HarmonicAnalyzer::prepare (double sampleRate)
+{
+    fs = sampleRate;
+    reset();
+}
+
+void HarmonicAnalyzer::reset()
+{
+    std::fill (averagedPower.begin(), averagedPower.end(), 0.0f);
+    numAveraged = 0;
+    lastFundamentalBin = 0;
+}
+
+void HarmonicAnalyzer::setWindow (AnalysisPipeline::Window newWindow)
+{
+    if (newWindow == window)
+        return;
+
+    window = newWindow;
+    reset();
+}
+
+double HarmonicAnalyzer::sumLobe (int centreBin) const
+{
+    auto halfWidth = lobeHalfWidths[(size_t) window];
+    auto sum = 0.0;
+
+    for (int n = juce::jmax (0, centreBin - halfWidth); n <= juce::jmin (numBins - 1, centreBin + halfWidth); ++n)
+        sum += averagedPower[(size_t) n];
+
+    return sum;
+}
+
+void HarmonicAnalyzer::processFrame (const float* magnitudes, Result& result)
+{
+    auto halfWidth = lobeHalfWidths[(size_t) window];
+    auto binWidth = fs / (double) fftSize;
+
+    // A different tone starts the average over, rather than smearing the two together
+    auto peakBin = halfWidth + 1;
+
+    for (int n = peakBin + 1; n < numBins - halfWidth; ++n)
+        if (magnitudes[n] > magnitudes[peakBin])
+            peakBin = n;
+
+    if (std::abs (peakBin - lastFundamentalBin) > 2)
+        numAveraged = 0;
+
+    lastFundamentalBin = peakBin;
+
+    // Mean of the frames so far, then a running average over averagingFrames
+    numAveraged = juce::jmin (numAveraged + 1, averagingFrames);
+    auto weight = 1.0f / (float) numAveraged;
+
+    for (int n = 0; n < numBins; ++n)
+        averagedPower[(size_t) n] += weight * (magnitudes[n] * magnitudes[n] - averagedPower[(size_t) n]);
+
+    // The fundamental's lobe has to clear DC on one side and the second harmonic's on the other
+    result.isValid = peakBin > 2 * halfWidth && averagedPower[(size_t) peakBin] > floorPower;
+
+    if (not result.isValid)
+    {
+        result.numHarmonics = 0;
+        return;
+    }
+
+    // Gaussian fit, a parabola through the log powers
+    auto a = std::log (averagedPower[(size_t) peakBin - 1] + floorPower);
+    auto b = std::log (averagedPower[(size_t) peakBin] + floorPower);
+    auto c = std::log (averagedPower[(size_t) peakBin + 1] + floorPower);
+    auto denominator = a - 2.0f * b + c;
+    auto offset = denominator < 0.0f ? juce::jlimit (-0.5f, 0.5f, 0.5f * (a - c) / denominator) : 0.0f;
+    auto fundamentalBin = (float) peakBin + offset;
+
+    // Lobe sums over fftSize^2 * ENBW read a sine at half its amplitude, like the display
+    auto levelScale = 1.0 / ((double) fftSize * (double) fftSize * noiseBandwidths[(size_t) window]);
+    auto toDecibels = [levelScale] (double power) { return (float) (10.0 * std::log10 (juce::jmax ((double) floorPower, power * levelScale))); };
+
+    auto fundamentalPower = sumLobe (peakBin);
+    result.harmonics[0] = { (float) (fundamentalBin * binWidth), toDecibels (fundamentalPower) };
+    result.numHarmonics = 1;
+
+    // Summed in double, the noise can be a part in 10^10 of the total
+    auto harmonicPower = 0.0;
+
+    for (int h = 2; h <= maxHarmonics; ++h)
+    {
+        auto bin = juce::roundToInt ((float) h * fundamentalBin);
+
+        if (bin + halfWidth >= numBins || bin * binWidth > highestFrequency)
+            break;
+
+        auto power = sumLobe (bin);
+        harmonicPower += power;
+        result.harmonics[(size_t) result.numHarmonics++] = { (float) (h * fundamentalBin * binWidth), toDecibels (power) };
+    }
+
+    // Everything in the audio band, clear of the DC lobe
+    auto lowBin = juce::jmax (halfWidth + 1, (int) std::ceil (lowestFrequency / binWidth));
+    auto highBin = juce::jmin (numBins - 1, (int) std::floor (highestFrequency / binWidth));
+    auto totalPower = 0.0;
+
+    for (int n = lowBin; n <= highBin; ++n)
+        totalPower += averagedPower[(size_t) n];
+
+    auto distortionAndNoise = juce::jmax ((double) floorPower, totalPower - fundamentalPower);
+    auto noise = juce::jmax ((double) floorPower, distortionAndNoise - harmonicPower);
+
+    result.thd = (float) (100.0 * std::sqrt (harmonicPower / fundamentalPower));
+    result.thdN = (float) (100.0 * std::sqrt (distortionAndNoise / fundamentalPower));
+    result.snr = (float) (10.0 * std::log10 (fundamentalPower / noise));
+}
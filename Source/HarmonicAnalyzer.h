@@ -0,0 +1,88 @@
+/*
+==============================================================================
+
+    HarmonicAnalyzer.h
+    Created: 19 Oct 2026 4:24:52am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalysisPipeline.h"
+
+//==============================================================================
+/*
+    Distortion measurement of a test tone: the fundamental, its harmonics,
+    THD, THD+N and SNR.
+
+    The bin powers are averaged over a few frames first, so the readings hold
+    still. The fundamental is the strongest bin, refined with a Gaussian fit.
+    Each tone's power is the sum over its window's main lobe, which is right
+    wherever the tone falls between bins. The noise is everything from 20 Hz
+    to 20 kHz that isn't the fundamental or a harmonic.
+
+    Meant for the Blackman-Harris and flat-top windows, whose lobes are wide
+    but whose sidelobes are too low to hide a harmonic. The fundamental has to
+    be far enough up for its lobe to clear DC and the second harmonic's, about
+    250 Hz at 48 kHz, or the result isn't valid.
+*/
+
+class HarmonicAnalyzer
+{
+public:
+    static constexpr int maxHarmonics = 10; // Counting the fundamental
+
+    struct Harmonic
+    {
+        float frequency = 0.0f; // Hz
+        float level = -200.0f;  // dB, same scale as the spectrum display
+    };
+
+    struct Result
+    {
+        bool isValid = false;
+
+        // harmonics[0] is the fundamental
+        std::array<Harmonic, maxHarmonics> harmonics;
+        int numHarmonics = 0;
+
+        float thd = 0.0f;   // Percent
+        float thdN = 0.0f;  // Percent
+        float snr = 0.0f;   // dB
+    };
+
+    explicit HarmonicAnalyzer (int fftSize);
+
+    void prepare (double sampleRate);
+    void reset();
+
+    // Audio thread. Restarts the averaging when the window changes.
+    void setWindow (AnalysisPipeline::Window newWindow);
+
+    // Audio thread, once per frame. magnitudes holds fftSize / 2 bins.
+    void processFrame (const float* magnitudes, Result& result);
+
+private:
+    double sumLobe (int centreBin) const;
+
+    static constexpr int averagingFrames = 8;
+
+    const int fftSize;
+    const int numBins;
+    double fs = 44100.0;
+
+    AnalysisPipeline::Window window = AnalysisPipeline::Window::blackmanHarris;
+
+    // Per window: equivalent noise bandwidth and how many bins either side of a tone to sum
+    std::array<float, AnalysisPipeline::numWindows> noiseBandwidths {};
+    std::array<int, AnalysisPipeline::numWindows> lobeHalfWidths { 3, 5, 6 };
+
+    std::vector<float> averagedPower;
+    int numAveraged = 0;
+    int lastFundamentalBin = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (HarmonicAnalyzer)
+};
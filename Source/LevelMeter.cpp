@@ -0,0 +1,228 @@
+/*
+==============================================================================
+
+    LevelMeter.cpp
+    Created: 19 Oct 2026 4:03:19am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "LevelMeter.h"
+
+//==============================================================================
+LevelMeter::LevelMeter()
+{
+    // Windowed-sinc lowpass at the original Nyquist, split into one set of taps per output phase
+    const int numTaps = oversampling * tapsPerPhase;
+    const auto centre = (numTaps - 1) * 0.5;
+
+    for (int i = 0; i < numTaps; ++i)
+    {
+        auto t = (i - centre) / oversampling;
+        auto sinc = t == 0.0 ? 1.0 : std::sin (juce::MathConstants<double>::pi * t) / (juce::MathConstants<double>::pi * t);
+        auto window = 0.5 - 0.5 * std::cos (juce::MathConstants<double>::twoPi * (i + 0.5) / numTaps);
+
+        taps[(size_t) (i % oversampling)][(size_t) (i / oversampling)] = (float) (sinc * window);
+    }
+
+    // Unity gain at DC for every phase
+    for (auto& phase : taps)
+    {
+        auto sum = std::accumulate (phase.begin(), phase.end(), 0.0f);
+
+        for (auto& tap : phase)
+            tap /= sum;
+    }
+}
+
+void LevelMeter::prepare (double sampleRate)
+{
+    // BS.1770 K-weighting, with the coefficients worked out for any sample rate
+    // the same way libebur128 does it
+    {
+        const auto f0 = 1681.974450955533;
+        const auto gain = 3.999843853973347;
+        const auto q = 0.7071752369554196;
+
+        auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        auto vh = std::pow (10.0, gain / 20.0);
+        auto vb = std::pow (vh, 0.4996667741545416);
+        auto a0 = 1.0 + k / q + k * k;
+
+        juce::dsp::IIR::Coefficients<float>::Ptr coefficients =
+            new juce::dsp::IIR::Coefficients<float> ((float) ((vh + vb * k / q + k * k) / a0),
+                                                     (float) (2.0 * (k * k - vh) / a0),
+                                                     (float) ((vh - vb * k / q + k * k) / a0),
+                                                     1.0f,
+                                                     (float) (2.0 * (k * k - 1.0) / a0),
+                                                     (float) ((1.0 - k / q + k * k) / a0));
+
+        for (auto& filter : shelfFilters)
+            filter.coefficients = coefficients;
+    }
+
+    {
+        const auto f0 = 38.13547087602444;
+        const auto q = 0.5003270373238773;
+
+        auto k = std::tan (juce::MathConstants<double>::pi * f0 / sampleRate);
+        auto a0 = 1.0 + k / q + k * k;
+
+        juce::dsp::IIR::Coefficients<float>::Ptr coefficients =
+            new juce::dsp::IIR::Coefficients<float> (1.0f, -2.0f, 1.0f,
+                                                     1.0f,
+                                                     (float) (2.0 * (k * k - 1.0) / a0),
+                                                     (float) ((1.0 - k / q + k * k) / a0));
+
+        for (auto& filter : highPassFilters)
+            filter.coefficients = coefficients;
+    }
+
+    blockLength = juce::roundToInt (sampleRate * 0.1);
+    interpolatorInput.assign ((size_t) (tapsPerPhase - 1 + blockLength), 0.0f);
+    interpolatorOutput.assign ((size_t) blockLength, 0.0f);
+
+    reset();
+}
+
+void LevelMeter::reset()
+{
+    for (auto& filter : shelfFilters)
+        filter.reset();
+
+    for (auto& filter : highPassFilters)
+        filter.reset();
+
+    for (auto& h : history)
+        h.fill (0.0f);
+
+    peak = 0.0f;
+    truePeak = 0.0f;
+
+    blockPosition = 0;
+    blockEnergy = 0.0;
+    blockSquares = 0.0;
+    energies.fill (0.0);
+    squares.fill (0.0);
+    ringIndex = 0;
+    numBlocks = 0;
+}
+
+void LevelMeter::process (const juce::AudioBuffer<float>& buffer, int numChannels)
+{
+    numChannels = juce::jmin (numChannels, (int) maxChannels, buffer.getNumChannels());
+
+    if (numChannels == 0)
+        return;
+
+    // Split the block where a 100 ms loudness block ends, so every channel's
+    // squares land in the right one
+    int start = 0;
+
+    while (start < buffer.getNumSamples())
+    {
+        auto length = juce::jmin (buffer.getNumSamples() - start, blockLength - blockPosition);
+
+        // RMS is the average over channels, loudness the sum
+        for (int channel = 0; channel < numChannels; ++channel)
+            processChannel (channel, buffer.getReadPointer (channel, start), length, 1.0 / numChannels);
+
+        blockPosition += length;
+        start += length;
+
+        if (blockPosition == blockLength)
+            finishBlock();
+    }
+}
+
+void LevelMeter::processChannel (int channel, const float* data, int numSamples, double squaresScale)
+{
+    auto& shelf = shelfFilters[(size_t) channel];
+    auto& highPass = highPassFilters[(size_t) channel];
+    auto& h = history[(size_t) channel];
+
+    auto range = juce::FloatVectorOperations::findMinAndMax (data, numSamples);
+    peak = juce::jmax (peak, -range.getStart(), range.getEnd());
+
+    double energy = 0.0;
+    double sumOfSquares = 0.0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto x = data[i];
+        sumOfSquares += x * x;
+
+        auto weighted = highPass.processSample (shelf.processSample (x));
+        energy += weighted * weighted;
+    }
+
+    blockEnergy += energy;
+    blockSquares += sumOfSquares * squaresScale;
+
+    // input[i] is this block's sample i, with the last of the one before in front
+    auto* input = interpolatorInput.data() + tapsPerPhase - 1;
+    auto* output = interpolatorOutput.data();
+    std::copy (h.begin(), h.end(), interpolatorInput.begin());
+    std::copy (data, data + numSamples, input);
+
+    // Each phase is a short FIR over the whole block, built up a tap at a time
+    for (const auto& phase : taps)
+    {
+        juce::FloatVectorOperations::multiply (output, input, phase[0], numSamples);
+
+        for (int t = 1; t < tapsPerPhase; ++t)
+            juce::FloatVectorOperations::addWithMultiply (output, input - t, phase[(size_t) t], numSamples);
+
+        auto phaseRange = juce::FloatVectorOperations::findMinAndMax (output, numSamples);
+        truePeak = juce::jmax (truePeak, -phaseRange.getStart(), phaseRange.getEnd());
+    }
+
+    std::copy (input + numSamples - (tapsPerPhase - 1), input + numSamples, h.begin());
+}
+
+void LevelMeter::finishBlock()
+{
+    energies[(size_t) ringIndex] = blockEnergy / blockLength;
+    squares[(size_t) ringIndex] = blockSquares / blockLength;
+
+    ringIndex = (ringIndex + 1) % shortTermBlocks;
+    numBlocks = juce::jmin (numBlocks + 1, (int) shortTermBlocks);
+
+    blockPosition = 0;
+    blockEnergy = 0.0;
+    blockSquares = 0.0;
+}
+
+void LevelMeter::getReadings (Readings& readings)
+{
+    // Mean of the last count finished blocks in a ring
+    auto average = [this] (const std::array<double, shortTermBlocks>& ring, int count)
+    {
+        count = juce::jmin (count, numBlocks);
+
+        if (count == 0)
+            return 0.0;
+
+        double sum = 0.0;
+
+        for (int i = 1; i <= count; ++i)
+            sum += ring[(size_t) ((ringIndex - i + shortTermBlocks) % shortTermBlocks)];
+
+        return sum / count;
+    };
+
+    auto toLoudness = [] (double meanSquare)
+    {
+        return meanSquare > 0.0 ? juce::jmax (-100.0f, (float) (-0.691 + 10.0 * std::log10 (meanSquare))) : -100.0f;
+    };
+
+    readings.peak = juce::Decibels::gainToDecibels (peak);
+    readings.truePeak = juce::Decibels::gainToDecibels (truePeak);
+    readings.rms = juce::Decibels::gainToDecibels ((float) std::sqrt (average (squares, rmsBlocks)));
+    readings.momentary = toLoudness (average (energies, momentaryBlocks));
+    readings.shortTerm = toLoudness (average (energies, shortTermBlocks));
+
+    peak = 0.0f;
+    truePeak = 0.0f;
+}
@@ -0,0 +1,91 @@
+/*
+==============================================================================
+
+    LevelMeter.h
+    Created: 19 Oct 2026 4:03:19am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Sample peak, true peak, RMS and BS.1770 loudness for the analyzer input.
+
+    The sample peak and the 4x polyphase interpolator for the true peak run
+    over each channel's block with the vector operations, one phase at a
+    time. The K-weighting filters are recursive, so they stay a loop over the
+    samples, and the plain squares are summed in the same loop for nothing.
+    The squares are gathered into 100 ms blocks, which make up the 300 ms RMS
+    window, the 400 ms momentary and the 3 s short-term loudness.
+*/
+
+class LevelMeter
+{
+public:
+    enum
+    {
+        maxChannels = 2,
+        oversampling = 4,
+        tapsPerPhase = 12,
+        momentaryBlocks = 4,   // 400 ms
+        shortTermBlocks = 30,  // 3 s
+        rmsBlocks = 3          // 300 ms
+    };
+
+    struct Readings
+    {
+        float peak = -100.0f;      // dBFS, highest since the last readings
+        float truePeak = -100.0f;  // dBTP, same
+        float rms = -100.0f;       // dBFS
+        float momentary = -100.0f; // LUFS
+        float shortTerm = -100.0f; // LUFS
+    };
+
+    LevelMeter();
+
+    void prepare (double sampleRate);
+    void reset();
+
+    // Audio thread
+    void process (const juce::AudioBuffer<float>& buffer, int numChannels);
+
+    // Audio thread, restarts the peak hold for the next readings
+    void getReadings (Readings& readings);
+
+private:
+    void processChannel (int channel, const float* data, int numSamples, double squaresScale);
+    void finishBlock();
+
+    std::array<juce::dsp::IIR::Filter<float>, maxChannels> shelfFilters;
+    std::array<juce::dsp::IIR::Filter<float>, maxChannels> highPassFilters;
+
+    // Polyphase interpolator, taps[phase][tap], and the last tapsPerPhase - 1
+    // inputs per channel, which go in front of the next block
+    std::array<std::array<float, tapsPerPhase>, oversampling> taps {};
+    std::array<std::array<float, tapsPerPhase - 1>, maxChannels> history {};
+
+    // Sized in prepare() for the longest piece process() hands on, a 100 ms block:
+    // the history and the input in a row, and one phase of the interpolator's output
+    std::vector<float> interpolatorInput;
+    std::vector<float> interpolatorOutput;
+
+    float peak = 0.0f;
+    float truePeak = 0.0f;
+
+    // Running 100 ms block and the ring of finished ones
+    int blockLength = 4800;
+    int blockPosition = 0;
+    double blockEnergy = 0.0;         // K-weighted, summed over channels
+    double blockSquares = 0.0;        // Unweighted, averaged over channels
+    std::array<double, shortTermBlocks> energies {};
+    std::array<double, shortTermBlocks> squares {};
+    int ringIndex = 0;
+    int numBlocks = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelMeter)
+};
@@ -0,0 +1,78 @@
+/*
+==============================================================================
+
+    LevelOfDetail.cpp
+    Created: 19 Oct 2026 4:15:25am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "LevelOfDetail.h"
+
+//==============================================================================
+LevelOfDetail::LevelOfDetail (double paintBudgetMs)
+    : budgetMs (paintBudgetMs)
+{
+}
+
+void LevelOfDetail::setArea (double numPixels)
+{
+    // Roughly: up to a laptop screen, up to 1440p, and beyond
+    if (numPixels <= 1.5e6)
+        areaLevel = 0;
+    else if (numPixels <= 4.0e6)
+        areaLevel = 1;
+    else
+        areaLevel = 2;
+
+    level = areaLevel;
+    averageMs = 0.0;
+    paintsSinceChange = 0;
+}
+
+bool LevelOfDetail::addPaintTime (double milliseconds)
+{
+    // Half a second or so of paints to average over, and as long again before
+    // the next change so a single slow paint doesn't make the display flicker
+    constexpr int settlePaints = 15;
+    constexpr double smoothing = 0.1;
+
+    averageMs = paintsSinceChange == 0 ? milliseconds
+                                       : averageMs + smoothing * (milliseconds - averageMs);
+
+    if (++paintsSinceChange < settlePaints)
+        return false;
+
+    auto newLevel = level;
+
+    if (averageMs > budgetMs)
+        newLevel = juce::jmin (maxLevel, level + 1);
+    else if (averageMs < 0.4 * budgetMs)
+        newLevel = juce::jmax (areaLevel, level - 1);
+
+    if (newLevel == level)
+        return false;
+
+    level = newLevel;
+    paintsSinceChange = 0;
+    return true;
+}
+
+float LevelOfDetail::getMinimumPointSpacing() const noexcept
+{
+    constexpr float spacing[] = { 0.0f, 1.0f, 2.0f, 4.0f };
+    return spacing[level];
+}
+
+float LevelOfDetail::getOutlineRounding() const noexcept
+{
+    constexpr float rounding[] = { 20.0f, 10.0f, 4.0f, 0.0f };
+    return rounding[level];
+}
+
+int LevelOfDetail::getRepaintRateHz() const noexcept
+{
+    constexpr int rates[] = { 30, 30, 20, 15 };
+    return rates[level];
+}
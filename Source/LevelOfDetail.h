@@ -0,0 +1,58 @@
+/*
+==============================================================================
+
+    LevelOfDetail.h
+    Created: 19 Oct 2026 4:15:25am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Decides how much detail the analyzer can afford to draw, so a full-screen
+    window on a 4K display stays inside a fixed paint budget.
+
+    The window area sets the starting level. After that the measured paint
+    time moves it: up when the average goes over budget, back down (never
+    below the area's level) when there's plenty of room. Each level merges
+    more bins into each drawn point, rounds the outline less, and from level 2
+    repaints less often.
+*/
+
+class LevelOfDetail
+{
+public:
+    static constexpr int maxLevel = 3;
+
+    explicit LevelOfDetail (double paintBudgetMs = 8.0);
+
+    // Size of the drawing area in physical pixels. Starts the measurement over.
+    void setArea (double numPixels);
+
+    // Call after every paint. Returns true if the level changed.
+    bool addPaintTime (double milliseconds);
+
+    int getLevel() const noexcept { return level; }
+
+    // Drawn points closer together than this, in pixels, are merged into one
+    float getMinimumPointSpacing() const noexcept;
+
+    // Corner radius for the outline path, zero for straight segments
+    float getOutlineRounding() const noexcept;
+
+    int getRepaintRateHz() const noexcept;
+
+private:
+    const double budgetMs;
+    int areaLevel = 0;
+    int level = 0;
+    double averageMs = 0.0;
+    int paintsSinceChange = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LevelOfDetail)
+};
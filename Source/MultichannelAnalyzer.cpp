@@ -0,0 +1,249 @@
+/*
+==============================================================================
+
+    MultichannelAnalyzer.cpp
+    Created: 19 Oct 2026 4:30:36am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "MultichannelAnalyzer.h"
+
+//==============================================================================
+class MultichannelAnalyzer::Worker  : public juce::Thread
+{
+public:
+    Worker (MultichannelAnalyzer& o, int index)
+        : juce::Thread ("Spectrum worker " + juce::String (index)),
+          owner (o),
+          fft (o.fftOrder),
+          scratch ((size_t) (2 * o.fftSize), 0.0f)
+    {
+    }
+
+    void run() override
+    {
+        // Parked until the message thread finds a frame waiting, so the audio
+        // thread never signals anyone and an idle pool never wakes
+        while (not threadShouldExit())
+        {
+            wait (-1);
+
+            if (threadShouldExit())
+                break;
+
+            owner.runJobs (fft, scratch);
+        }
+    }
+
+private:
+    MultichannelAnalyzer& owner;
+    juce::dsp::FFT fft;
+    std::vector<float> scratch;
+};
+
+//==============================================================================
+MultichannelAnalyzer::MultichannelAnalyzer (int order)
+    : fftOrder (order),
+      fftSize (1 << order),
+      window ((size_t) (1 << order)),
+      inlineFFT (order),
+      inlineScratch ((size_t) (2 << order), 0.0f)
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables (window.data(), (size_t) fftSize,
+                                                               juce::dsp::WindowingFunction<float>::hann, true);
+
+    for (auto& set : fifos)
+        set.resize ((size_t) (maxChannels * fftSize), 0.0f);
+
+    smoothed.resize ((size_t) (maxChannels * fftSize / 2), 0.0f);
+    levels.resize ((size_t) (maxChannels * fftSize / 2), -200.0f);
+}
+
+MultichannelAnalyzer::~MultichannelAnalyzer()
+{
+    release();
+}
+
+void MultichannelAnalyzer::prepare (double, int newNumChannels)
+{
+    release();
+
+    numChannels = juce::jlimit (0, maxChannels, newNumChannels);
+    numBuffered = 0;
+    std::fill (smoothed.begin(), smoothed.end(), 0.0f);
+    std::fill (levels.begin(), levels.end(), -200.0f);
+    state = State::idle;
+}
+
+void MultichannelAnalyzer::setActive (bool shouldBeActive)
+{
+    const juce::ScopedLock sl (workerLock);
+
+    if (shouldBeActive == active.load())
+        return;
+
+    if (not shouldBeActive)
+    {
+        // push() stops handing out frames before the workers go
+        active = false;
+        stopWorkers();
+        return;
+    }
+
+    // A stereo pair is quicker to analyse than to hand over, so it's done
+    // in service() on the message thread. Otherwise leave a core for the
+    // audio thread and one for the rest of the host.
+    if (numChannels > minThreadedChannels)
+    {
+        auto numWorkers = juce::jlimit (1, juce::jmin (8, numChannels), juce::SystemStats::getNumCpus() - 2);
+
+        for (int w = 0; w < numWorkers; ++w)
+        {
+            workers.push_back (std::make_unique<Worker> (*this, w + 1));
+            workers.back()->startThread();
+        }
+    }
+
+    active = numChannels > 0;
+}
+
+void MultichannelAnalyzer::release()
+{
+    setActive (false);
+}
+
+void MultichannelAnalyzer::stopWorkers()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    for (auto& worker : workers)
+    {
+        worker->notify();
+        worker->stopThread (1000);
+    }
+
+    workers.clear();
+}
+
+void MultichannelAnalyzer::service()
+{
+    if (not active.load() || not hasJobs())
+        return;
+
+    const juce::ScopedLock sl (workerLock);
+
+    if (workers.empty())
+    {
+        runJobs (inlineFFT, inlineScratch);
+        return;
+    }
+
+    for (auto& worker : workers)
+        worker->notify();
+}
+
+void MultichannelAnalyzer::push (const float* const* channels, int numSamples)
+{
+    if (numChannels == 0 || not active.load())
+        return;
+
+    auto start = 0;
+
+    while (start < numSamples)
+    {
+        auto numToCopy = juce::jmin (numSamples - start, fftSize - numBuffered);
+        auto* set = fifos[(size_t) fillingSet].data();
+
+        for (int c = 0; c < numChannels; ++c)
+            std::copy (channels[c] + start, channels[c] + start + numToCopy, set + c * fftSize + numBuffered);
+
+        numBuffered += numToCopy;
+        start += numToCopy;
+
+        if (numBuffered < fftSize)
+            break;
+
+        numBuffered = 0;
+
+        // Hand the full set to the workers and fill the other, unless they or
+        // the display are still busy with the last one
+        if (state.load() != State::idle)
+        {
+            ++droppedFrames;
+            continue;
+        }
+
+        jobSet = fillingSet;
+        fillingSet ^= 1;
+
+        channelsRemaining = numChannels;
+        nextChannel = 0;
+        state = State::running;
+    }
+}
+
+bool MultichannelAnalyzer::hasJobs() const
+{
+    return state.load() == State::running && nextChannel.load() < numChannels;
+}
+
+void MultichannelAnalyzer::runJobs (juce::dsp::FFT& fft, std::vector<float>& scratch)
+{
+    for (;;)
+    {
+        auto channel = nextChannel.fetch_add (1);
+
+        if (channel >= numChannels)
+            return;
+
+        analyseChannel (channel, fft, scratch);
+
+        if (channelsRemaining.fetch_sub (1) == 1)
+            state = State::ready;
+    }
+}
+
+void MultichannelAnalyzer::analyseChannel (int channel, juce::dsp::FFT& fft, std::vector<float>& scratch)
+{
+    const auto* input = fifos[(size_t) jobSet].data() + channel * fftSize;
+    auto* data = scratch.data();
+
+    for (int n = 0; n < fftSize; ++n)
+        data[n] = input[n] * window[(size_t) n];
+
+    fft.performRealOnlyForwardTransform (data, true);
+
+    auto numBins = fftSize / 2;
+    auto* smooth = smoothed.data() + channel * numBins;
+    auto* out = levels.data() + channel * numBins;
+    auto l = leak.load();
+    auto referenceDb = juce::Decibels::gainToDecibels ((float) fftSize);
+
+    for (int n = 0; n < numBins; ++n)
+    {
+        auto magnitude = std::sqrt (data[2 * n] * data[2 * n] + data[2 * n + 1] * data[2 * n + 1]);
+        smooth[n] = l * smooth[n] + (1.0f - l) * magnitude;
+        out[n] = juce::Decibels::gainToDecibels (smooth[n]) - referenceDb;
+    }
+}
+
+bool MultichannelAnalyzer::readLevels (std::vector<std::vector<float>>& levelsDb)
+{
+    if (state.load() != State::ready)
+        return false;
+
+    auto numBins = fftSize / 2;
+
+    for (int c = 0; c < juce::jmin (numChannels, (int) levelsDb.size()); ++c)
+    {
+        auto& dest = levelsDb[(size_t) c];
+        dest.resize ((size_t) numBins);
+        std::copy (levels.data() + c * numBins, levels.data() + (c + 1) * numBins, dest.begin());
+    }
+
+    state = State::idle;
+    return true;
+}
@@ -0,0 +1,120 @@
+/*
+==============================================================================
+
+    MultichannelAnalyzer.h
+    Created: 19 Oct 2026 4:30:36am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    A smoothed spectrum for every input channel, for surround and ambisonic
+    layouts of up to 16 channels.
+
+    The audio thread only copies samples into per-channel FIFOs. When a frame
+    is complete it marks the FIFOs as a job and carries on filling a second
+    set. It never signals a thread: the display's timer finds the job and
+    wakes a pool of worker threads, which are parked on an event otherwise.
+    Each worker takes channels off a shared counter until none are left, so
+    a core that falls behind never holds up the others, and windows,
+    transforms and smooths the channels it takes. The last to finish marks
+    the frame ready for the display.
+
+    The pool only exists while the Channels display is chosen and the input
+    is wider than stereo. A stereo pair is analysed on the message thread.
+
+    Only these lanes see the whole layout. The meters, loudness, capture and
+    every other display take the first two channels and are labelled so.
+
+    As with the main spectrum, nothing new starts until the display has taken
+    the last frame, and frames that complete in the meantime are dropped.
+*/
+
+class MultichannelAnalyzer
+{
+public:
+    static constexpr int maxChannels = 16;
+
+    explicit MultichannelAnalyzer (int fftOrder);
+    ~MultichannelAnalyzer();
+
+    // Not the audio thread. Nothing runs until the lanes are made active,
+    // and release() deactivates them.
+    void prepare (double sampleRate, int numChannels);
+    void release();
+
+    // Not the audio thread. Starts the workers for the Channels display, if
+    // there are more channels than service() takes itself, or stops them.
+    void setActive (bool shouldBeActive);
+
+    void setLeak (float newLeak) { leak = newLeak; }
+
+    // Audio thread
+    void push (const float* const* channels, int numSamples);
+
+    // Message thread. Copies each channel's levels, in dB on the spectrum
+    // display's scale, if there's a new frame, and lets the next one start.
+    bool readLevels (std::vector<std::vector<float>>& levelsDb);
+
+    // Message thread, from the display's timer. Wakes the workers if a frame
+    // is waiting for them, or analyses it here when there are none.
+    void service();
+
+    int getNumChannels() const { return numChannels; }
+    int getNumBins() const { return fftSize / 2; }
+    int getNumDroppedFrames() const { return droppedFrames.load(); }
+
+private:
+    class Worker;
+
+    bool hasJobs() const;
+    void stopWorkers();
+    void runJobs (juce::dsp::FFT& fft, std::vector<float>& scratch);
+    void analyseChannel (int channel, juce::dsp::FFT& fft, std::vector<float>& scratch);
+
+    enum class State
+    {
+        idle,
+        running,
+        ready
+    };
+
+    const int fftOrder;
+    const int fftSize;
+    int numChannels = 0;
+
+    std::vector<float> window;
+
+    // Two sets of channel FIFOs: the audio thread fills one while the workers read the other
+    std::array<std::vector<float>, 2> fifos;
+    int fillingSet = 0;
+    int jobSet = 1;
+    int numBuffered = 0;
+
+    std::atomic<State> state { State::idle };
+    std::atomic<int> nextChannel { 0 };
+    std::atomic<int> channelsRemaining { 0 };
+    std::atomic<int> droppedFrames { 0 };
+    std::atomic<float> leak { 0.0f };
+
+    // Smoothed magnitudes, then levels in dB, numChannels rows of fftSize / 2
+    std::vector<float> smoothed;
+    std::vector<float> levels;
+
+    // Up to a stereo pair, service() does the work on the message thread
+    static constexpr int minThreadedChannels = 2;
+
+    std::atomic<bool> active { false };
+    juce::CriticalSection workerLock;
+    std::vector<std::unique_ptr<Worker>> workers;
+    juce::dsp::FFT inlineFFT;
+    std::vector<float> inlineScratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MultichannelAnalyzer)
+};
@@ -0,0 +1,123 @@
+/*
+==============================================================================
+
+    NoiseFloorTracker.cpp
+    Created: 19 Oct 2026 4:56:54am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "NoiseFloorTracker.h"
+
+// Power smoothing per frame before the minimum is taken, about 100 ms at 48 kHz
+static constexpr float smoothing = 0.65f;
+
+// How far the minimum of noise smoothed as above sits below its mean, in dB,
+// for sub-windows of 1, 2, 4 ... 512 frames. Measured by simulation with
+// independent frames, which is what the FIFO gives as it doesn't overlap them.
+static constexpr std::array<float, 10> biasDb { 2.30f, 3.21f, 4.03f, 4.78f, 5.43f, 6.05f, 6.59f, 7.11f, 7.57f, 8.01f };
+
+static constexpr float unset = std::numeric_limits<float>::max();
+
+//==============================================================================
+NoiseFloorTracker::NoiseFloorTracker (int bins)
+    : numBins (bins)
+{
+    jassert (numBins > 0);
+
+    smoothedPower.resize ((size_t) numBins, 0.0f);
+    currentMinimum.resize ((size_t) numBins, unset);
+    windowMinimum.resize ((size_t) numBins, unset);
+    levels.resize ((size_t) numBins, 0.0f);
+    subWindowMinima.resize ((size_t) (numSubWindows * numBins), unset);
+}
+
+void NoiseFloorTracker::prepare (double sampleRate, int hopSize)
+{
+    framesPerSecond = sampleRate / hopSize;
+    windowSeconds = -1.0;
+}
+
+void NoiseFloorTracker::setWindowSeconds (double newSeconds)
+{
+    requestedSeconds = juce::jmax (0.0, newSeconds);
+}
+
+void NoiseFloorTracker::reset()
+{
+    resetRequested = true;
+}
+
+void NoiseFloorTracker::clearState()
+{
+    std::fill (currentMinimum.begin(), currentMinimum.end(), unset);
+    std::fill (windowMinimum.begin(), windowMinimum.end(), unset);
+    std::fill (subWindowMinima.begin(), subWindowMinima.end(), unset);
+    std::fill (levels.begin(), levels.end(), 0.0f);
+    framesInSubWindow = 0;
+    currentSubWindow = 0;
+    primed = false;
+}
+
+void NoiseFloorTracker::processFrame (const float* magnitudes) noexcept
+{
+    auto newSeconds = requestedSeconds.load();
+
+    if (resetRequested.exchange (false) || newSeconds != windowSeconds)
+    {
+        windowSeconds = newSeconds;
+        framesPerSubWindow = juce::jmax (1, (int) std::ceil (windowSeconds * framesPerSecond / numSubWindows));
+
+        // Between table entries the bias goes with the log of the sub-window length
+        auto position = juce::jlimit (0.0f, (float) biasDb.size() - 1.0f, std::log2 ((float) framesPerSubWindow));
+        auto index = juce::jmin ((int) position, (int) biasDb.size() - 2);
+        auto bias = biasDb[(size_t) index] + (position - (float) index) * (biasDb[(size_t) index + 1] - biasDb[(size_t) index]);
+
+        // The bias is a power ratio. Averaged magnitudes of noise read sqrt (pi / 4) of its RMS.
+        powerScale = std::pow (10.0f, bias / 10.0f) * juce::MathConstants<float>::pi / 4.0f;
+
+        clearState();
+    }
+
+    // The smoothing starts from the first frame rather than from silence
+    if (not primed)
+    {
+        for (int n = 0; n < numBins; ++n)
+            smoothedPower[(size_t) n] = magnitudes[n] * magnitudes[n];
+
+        primed = true;
+    }
+
+    auto* power = smoothedPower.data();
+    auto* current = currentMinimum.data();
+    const auto* window = windowMinimum.data();
+    auto* out = levels.data();
+
+    for (int n = 0; n < numBins; ++n)
+    {
+        power[n] = smoothing * power[n] + (1.0f - smoothing) * magnitudes[n] * magnitudes[n];
+        current[n] = juce::jmin (current[n], power[n]);
+        out[n] = std::sqrt (juce::jmin (current[n], window[n]) * powerScale);
+    }
+
+    if (++framesInSubWindow < framesPerSubWindow)
+        return;
+
+    // The sub-window is finished. It replaces the oldest, and the window's
+    // minimum is taken again over all of them, once every framesPerSubWindow frames.
+    std::copy (currentMinimum.begin(), currentMinimum.end(), subWindowMinima.begin() + currentSubWindow * numBins);
+    std::fill (currentMinimum.begin(), currentMinimum.end(), unset);
+    std::fill (windowMinimum.begin(), windowMinimum.end(), unset);
+
+    for (int s = 0; s < numSubWindows; ++s)
+    {
+        const auto* minima = subWindowMinima.data() + s * numBins;
+
+        for (int n = 0; n < numBins; ++n)
+            windowMinimum[(size_t) n] = juce::jmin (windowMinimum[(size_t) n], minima[n]);
+    }
+
+    currentSubWindow = (currentSubWindow + 1) % numSubWindows;
+    framesInSubWindow = 0;
+}
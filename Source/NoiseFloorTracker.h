@@ -0,0 +1,84 @@
+/*
+==============================================================================
+
+    NoiseFloorTracker.h
+    Created: 19 Oct 2026 4:56:54am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Noise floor per bin by minimum statistics: the power of each bin is
+    smoothed over a few frames, and the quietest it got over the last few
+    seconds is taken as the noise under whatever else is playing. Speech or
+    music come and go within the window, hiss and hum don't, so the minimum
+    follows the noise without having to know when the signal is absent.
+
+    The window is split into numSubWindows sub-windows. Each bin keeps the
+    minimum of the sub-window in progress and of each of the last
+    numSubWindows finished ones, so the memory is the same for a window of
+    one second or one minute, and a frame costs one pass over the bins. The
+    window slides a sub-window at a time.
+
+    The minimum of a noisy estimate sits below its mean, by more the longer
+    the window, so it's scaled back up by a bias worked out for the window
+    length. The levels come out as noise reads on the spectrum display, as
+    averaged magnitudes on the scale of smoothedFftData.
+*/
+
+class NoiseFloorTracker
+{
+public:
+    static constexpr int numSubWindows = 8;
+
+    explicit NoiseFloorTracker (int numBins);
+
+    // Frames come every hopSize samples
+    void prepare (double sampleRate, int hopSize);
+
+    // Any thread, picked up by the next frame
+    void setWindowSeconds (double newSeconds);
+    void reset();
+
+    // Audio thread, once per frame of numBins magnitudes
+    void processFrame (const float* magnitudes) noexcept;
+
+    const float* getLevels() const noexcept { return levels.data(); }
+    int getNumBins() const noexcept { return numBins; }
+
+private:
+    void clearState();
+
+    const int numBins;
+
+    double framesPerSecond = 44100.0 / 2048.0;
+    int framesPerSubWindow = 1;
+    int framesInSubWindow = 0;
+    int currentSubWindow = 0;
+    bool primed = false;
+
+    std::atomic<double> requestedSeconds { 2.0 };
+    std::atomic<bool> resetRequested { false };
+    double windowSeconds = -1.0; // Not applied yet
+
+    // Power to noise level on the display: the bias and the averaging of magnitudes
+    float powerScale = 1.0f;
+
+    // Per bin: smoothed power, minimum of the sub-window in progress, minimum
+    // of the finished ones and the published level
+    std::vector<float> smoothedPower;
+    std::vector<float> currentMinimum;
+    std::vector<float> windowMinimum;
+    std::vector<float> levels;
+
+    // numSubWindows rows of numBins, the minimum of each finished sub-window
+    std::vector<float> subWindowMinima;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NoiseFloorTracker)
+};
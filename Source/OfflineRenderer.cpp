@@ -0,0 +1,221 @@
+/*
+==============================================================================
+
+    OfflineRenderer.cpp
+    Created: 19 Oct 2026 4:33:17am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "OfflineRenderer.h"
+#include "PluginProcessor.h"
+#include "Analyzer.h"
+
+//==============================================================================
+// Made and destroyed on the message thread, which is where the processor and
+// the Analyzer component expect to be set up. Only runJob goes to the pool.
+class OfflineRenderer::Job  : public juce::ThreadPoolJob
+{
+public:
+    Job (const Settings& s, const juce::File& file, const juce::File& outputDirectory)
+        : juce::ThreadPoolJob (file.getFileName()),
+          settings (s),
+          audioFile (file),
+          destination (outputDirectory),
+          processor (PluginProcessor::Use::analysisOnly),
+          image (juce::Image::RGB, s.width, s.height, true)
+    {
+        formats.registerBasicFormats();
+        reader.reset (formats.createReaderFor (audioFile));
+
+        if (reader == nullptr)
+            return;
+
+        // Infinite averaging makes the last frame the average of the whole file,
+        // and infinite hold makes the outline the loudest each bin got anywhere in it
+        if (settings.output == Output::longTerm)
+        {
+            processor.setParameterValue ("avgMode", (float) SpectrumAverager::Mode::infinite);
+            processor.setParameterValue ("infiniteHold", 1.0f);
+        }
+
+        processor.prepareToPlay (reader->sampleRate, blockSize);
+
+        scope = std::make_unique<Analyzer> (processor, reader->sampleRate);
+        scope->setSize (settings.width, settings.height);
+        scope->stopTimer(); // We take the frames ourselves
+    }
+
+    ~Job() override
+    {
+        scope.reset();
+        processor.releaseResources();
+    }
+
+    JobStatus runJob() override
+    {
+        if (reader == nullptr)
+        {
+            error = "Can't read " + audioFile.getFullPathName();
+            return jobHasFinished;
+        }
+
+        auto name = audioFile.getFileNameWithoutExtension();
+        auto framesFolder = destination.getChildFile (name);
+
+        if (settings.output == Output::frames && not framesFolder.createDirectory())
+        {
+            error = "Can't create " + framesFolder.getFullPathName();
+            return jobHasFinished;
+        }
+
+        // Mono files are read into both channels, anything past the first two is left out
+        juce::AudioBuffer<float> buffer (processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+
+        auto samplesPerImage = settings.framesPerSecond > 0.0 ? reader->sampleRate / settings.framesPerSecond : 0.0;
+        auto nextImage = samplesPerImage;
+        auto numImages = 0;
+
+        for (juce::int64 start = 0; start < reader->lengthInSamples; start += blockSize)
+        {
+            if (shouldExit())
+                return jobHasFinished;
+
+            // The last block is padded with silence
+            buffer.clear();
+            reader->read (&buffer, 0, (int) juce::jmin ((juce::int64) blockSize, reader->lengthInSamples - start), start, true, true);
+            processor.processBlock (buffer, midi);
+
+            auto newFrame = processor.nextFFTBlockReady.get();
+
+            if (newFrame)
+            {
+                if (settings.output == Output::frames)
+                    scope->drawNextFrameOfSpectrum();
+
+                processor.nextFFTBlockReady.set (false);
+            }
+
+            if (settings.output == Output::longTerm)
+                continue;
+
+            // Like the editor's timer, each image shows whatever frame came last
+            auto end = (double) (start + blockSize);
+            auto imageDue = samplesPerImage > 0.0 ? end >= nextImage : newFrame;
+
+            if (not imageDue)
+                continue;
+
+            nextImage += samplesPerImage;
+
+            auto imageFile = framesFolder.getChildFile (name + "_" + juce::String (numImages++).paddedLeft ('0', 5) + ".png");
+
+            if (not writeImage (imageFile))
+                return jobHasFinished;
+        }
+
+        if (settings.output == Output::longTerm)
+        {
+            scope->drawNextFrameOfSpectrum();
+            writeImage (destination.getChildFile (name + ".png"));
+        }
+
+        return jobHasFinished;
+    }
+
+    juce::String error;
+
+private:
+    bool writeImage (const juce::File& file)
+    {
+        {
+            // The fonts, typefaces and look-and-feel the paint goes through are
+            // shared and only made for one thread, so the jobs take turns. The
+            // message thread is waiting on the pool and doesn't paint meanwhile.
+            const juce::ScopedLock sl (paintLock);
+            juce::Graphics g (image);
+            scope->paint (g);
+        }
+
+        file.deleteFile();
+        juce::FileOutputStream stream (file);
+        juce::PNGImageFormat png;
+
+        if (stream.openedOk() && png.writeImageToStream (image, stream))
+            return true;
+
+        error = "Can't write " + file.getFullPathName();
+        return false;
+    }
+
+    // Well under a frame, so every frame is published within a block of completing
+    static constexpr int blockSize = 512;
+
+    static juce::CriticalSection paintLock;
+
+    const Settings settings;
+    const juce::File audioFile;
+    const juce::File destination;
+
+    juce::AudioFormatManager formats;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    PluginProcessor processor;
+    std::unique_ptr<Analyzer> scope;
+    juce::Image image;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Job)
+};
+
+juce::CriticalSection OfflineRenderer::Job::paintLock;
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer (const Settings& s)
+    : settings (s)
+{
+}
+
+juce::StringArray OfflineRenderer::render (const juce::Array<juce::File>& audioFiles, const juce::File& outputDirectory, int numThreads)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+
+    juce::StringArray errors;
+
+    if (not outputDirectory.createDirectory())
+    {
+        errors.add ("Can't create " + outputDirectory.getFullPathName());
+        return errors;
+    }
+
+    numThreads = juce::jmax (1, numThreads);
+    juce::ThreadPool pool (numThreads);
+
+    // Only as many files open as there are threads, each processor has its own buffers
+    std::deque<std::unique_ptr<Job>> running;
+
+    auto finishOldest = [&]
+    {
+        pool.waitForJobToFinish (running.front().get(), -1);
+
+        if (running.front()->error.isNotEmpty())
+            errors.add (running.front()->error);
+
+        running.pop_front();
+    };
+
+    for (const auto& file : audioFiles)
+    {
+        if ((int) running.size() == numThreads)
+            finishOldest();
+
+        running.push_back (std::make_unique<Job> (settings, file, outputDirectory));
+        pool.addJob (running.back().get(), false);
+    }
+
+    while (not running.empty())
+        finishOldest();
+
+    return errors;
+}
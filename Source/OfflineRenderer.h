@@ -0,0 +1,60 @@
+/*
+==============================================================================
+
+    OfflineRenderer.h
+    Created: 19 Oct 2026 4:33:17am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Renders the analyzer's display for audio files to PNGs, without a host or
+    a window, for reports that want a picture of every stem.
+
+    Each file gets its own analysis-only processor and Analyzer, fed from the file as fast
+    as it can be read, and paints into its own offscreen image with the same
+    drawing code the editor uses. Every frame is taken as soon as the processor
+    publishes it, so unlike a live capture none are ever dropped.
+
+    A file's frames depend on the ones before them (smoothing, averaging, the
+    onset lane), so it's the files that are spread over the cores. Only the
+    analysis runs side by side; the paints share fonts and the look-and-feel,
+    so they take turns.
+*/
+
+class OfflineRenderer
+{
+public:
+    enum class Output
+    {
+        frames,     // An image at every tick of framesPerSecond, in a folder per file
+        longTerm    // One image per file: its average spectrum, outlined by the loudest each bin got
+    };
+
+    struct Settings
+    {
+        Output output = Output::longTerm;
+        int width = 1200;
+        int height = 600;
+        double framesPerSecond = 30.0; // Same as the editor's timer, 0 for every analysis frame
+    };
+
+    explicit OfflineRenderer (const Settings& settings);
+
+    // Message thread, which has to exist. Renders each file into outputDirectory,
+    // up to numThreads of them at a time, and returns an error for each that failed.
+    juce::StringArray render (const juce::Array<juce::File>& audioFiles, const juce::File& outputDirectory, int numThreads);
+
+private:
+    class Job;
+
+    const Settings settings;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OfflineRenderer)
+};
@@ -0,0 +1,140 @@
+/*
+==============================================================================
+
+    OnsetDetector.cpp
+    Created: 19 Oct 2026 4:22:17am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "OnsetDetector.h"
+
+// Magnitudes are scaled so a full-scale sine is 1, then log(1 + compression * m).
+// At 1000, -60 dB counts about as much as a doubling of a loud bin.
+static constexpr float compression = 1000.0f;
+
+// An onset needs thresholdRatio times the recent median flux, plus a little
+// so a silent input doesn't trigger on nothing
+static constexpr float thresholdRatio = 1.5f;
+static constexpr float thresholdOffset = 0.02f;
+
+//==============================================================================
+OnsetDetector::OnsetDetector (int size)
+    : fftSize (size),
+      numBins (size / 2),
+      previous ((size_t) size / 2, 0.0f),
+      blockEnergy ((size_t) (size / blockSize), 0.0f)
+{
+}
+
+void OnsetDetector::prepare()
+{
+    reset();
+}
+
+void OnsetDetector::reset()
+{
+    std::fill (previous.begin(), previous.end(), 0.0f);
+    fluxHistory.fill (0.0f);
+    historyIndex = 0;
+    lastWasOnset = false;
+    hasPrevious = false;
+    previousTailEnergy = 0.0f;
+}
+
+void OnsetDetector::processFrame (const float* magnitudes, const float* samples, juce::int64 frameEnd, Result& result)
+{
+    // One pass: compress, rectified difference against the last frame, and keep this one
+    auto scale = compression * 2.0f / (float) fftSize;
+    auto flux = 0.0f;
+
+    for (int n = 0; n < numBins; ++n)
+    {
+        auto compressed = std::log1p (scale * magnitudes[n]);
+        flux += juce::jmax (0.0f, compressed - previous[(size_t) n]);
+        previous[(size_t) n] = compressed;
+    }
+
+    flux /= (float) numBins;
+
+    // The first frame after a reset has nothing to compare with
+    if (not hasPrevious)
+    {
+        flux = 0.0f;
+        hasPrevious = true;
+    }
+
+    std::array<float, historySize> sorted = fluxHistory;
+    std::nth_element (sorted.begin(), sorted.begin() + historySize / 2, sorted.end());
+    auto threshold = thresholdRatio * sorted[historySize / 2] + thresholdOffset;
+
+    fluxHistory[(size_t) historyIndex] = flux;
+    historyIndex = (historyIndex + 1) % historySize;
+
+    auto isOnset = flux > threshold && not lastWasOnset;
+    lastWasOnset = flux > threshold;
+
+    result.frameEnd = frameEnd;
+    result.flux = flux;
+    result.threshold = threshold;
+    result.isOnset = isOnset;
+
+    if (isOnset)
+    {
+        result.onsetSample = frameEnd - fftSize + findOnsetSample (samples);
+        result.strength = flux / threshold;
+    }
+
+    auto tailEnergy = 0.0f;
+
+    for (int n = fftSize - blockSize; n < fftSize; ++n)
+        tailEnergy += samples[n] * samples[n];
+
+    previousTailEnergy = tailEnergy;
+}
+
+int OnsetDetector::findOnsetSample (const float* samples) const
+{
+    auto numBlocks = (int) blockEnergy.size();
+
+    for (int b = 0; b < numBlocks; ++b)
+    {
+        auto energy = 0.0f;
+
+        for (int n = b * blockSize; n < (b + 1) * blockSize; ++n)
+            energy += samples[n] * samples[n];
+
+        blockEnergy[(size_t) b] = energy;
+    }
+
+    // The block with the biggest jump in energy over the one before
+    auto onsetBlock = 0;
+    auto biggestRise = blockEnergy[0] - previousTailEnergy;
+
+    for (int b = 1; b < numBlocks; ++b)
+    {
+        auto rise = blockEnergy[(size_t) b] - blockEnergy[(size_t) b - 1];
+
+        if (rise > biggestRise)
+        {
+            biggestRise = rise;
+            onsetBlock = b;
+        }
+    }
+
+    // Then the first sample in it that reaches half the attack's peak, looking
+    // one block further since the attack may straddle two
+    auto start = onsetBlock * blockSize;
+    auto end = juce::jmin (fftSize, start + 2 * blockSize);
+    auto peak = 0.0f;
+
+    for (int n = start; n < end; ++n)
+        peak = juce::jmax (peak, std::abs (samples[n]));
+
+    for (int n = start; n < end; ++n)
+        if (std::abs (samples[n]) >= 0.5f * peak)
+            return n;
+
+    return start;
+}
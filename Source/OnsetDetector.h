@@ -0,0 +1,73 @@
+/*
+==============================================================================
+
+    OnsetDetector.h
+    Created: 19 Oct 2026 4:22:17am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Onsets and transients from the spectral flux of successive FFT frames.
+
+    The flux is how much the magnitudes went up since the previous frame,
+    summed over the bins and ignoring bins that went down. The magnitudes are
+    log-compressed first, so a quiet hi-hat counts as much as a loud kick.
+    A frame is an onset when its flux is well above the median of the last few
+    frames and the frame before it wasn't one.
+
+    A frame is 2048 samples long, so the frame only says roughly when the
+    onset happened. The exact sample comes from the frame's time-domain
+    samples: the short block whose energy jumps the most, then the first
+    sample in it that gets near the block's peak.
+*/
+
+class OnsetDetector
+{
+public:
+    struct Result
+    {
+        juce::int64 frameEnd = 0;   // Input sample just after the frame
+        float flux = 0.0f;
+        float threshold = 0.0f;
+
+        bool isOnset = false;
+        juce::int64 onsetSample = 0; // Input sample the onset starts at
+        float strength = 0.0f;       // Flux over threshold, 1 is just enough
+    };
+
+    explicit OnsetDetector (int fftSize);
+
+    void prepare();
+    void reset();
+
+    // Audio thread, once per frame. magnitudes holds fftSize / 2 bins, samples
+    // the frame's fftSize unwindowed input samples ending at frameEnd.
+    void processFrame (const float* magnitudes, const float* samples, juce::int64 frameEnd, Result& result);
+
+private:
+    int findOnsetSample (const float* samples) const;
+
+    static constexpr int historySize = 8;
+    static constexpr int blockSize = 32;
+
+    const int fftSize;
+    const int numBins;
+
+    std::vector<float> previous; // Compressed magnitudes of the last frame
+    std::array<float, historySize> fluxHistory {};
+    int historyIndex = 0;
+    bool lastWasOnset = false;
+    bool hasPrevious = false;
+
+    float previousTailEnergy = 0.0f; // Last block of the previous frame
+    mutable std::vector<float> blockEnergy;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OnsetDetector)
+};
@@ -0,0 +1,88 @@
+/*
+==============================================================================
+
+    PeakDetector.cpp
+    Created: 19 Oct 2026 3:58:18am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "PeakDetector.h"
+
+//==============================================================================
+void PeakDetector::process (const float* magnitudes, int numBins, int fftSize,
+                            double sampleRate, float referenceDb, Result& result) const
+{
+    const auto wanted = numPeaks.load();
+    const auto threshold = thresholdDb.load() + referenceDb;
+    const auto method = interpolation.load();
+    const auto binWidth = (float) (sampleRate / fftSize);
+
+    result.numPeaks = 0;
+
+    if (wanted == 0)
+        return;
+
+    // Peak bins sorted by magnitude, strongest first
+    std::array<int, maxPeaks> bins {};
+    int found = 0;
+
+    // Skip DC and the last bin so both neighbours always exist
+    for (int k = 1; k < numBins - 1; ++k)
+    {
+        auto m = magnitudes[k];
+
+        if (m <= magnitudes[k - 1] || m < magnitudes[k + 1])
+            continue;
+
+        if (juce::Decibels::gainToDecibels (m) < threshold)
+            continue;
+
+        if (found == wanted && m <= magnitudes[bins[(size_t) found - 1]])
+            continue;
+
+        // Insert in order, dropping the weakest if we're full
+        auto pos = juce::jmin (found, wanted - 1);
+
+        while (pos > 0 && magnitudes[bins[(size_t) pos - 1]] < m)
+        {
+            bins[(size_t) pos] = bins[(size_t) pos - 1];
+            --pos;
+        }
+
+        bins[(size_t) pos] = k;
+        found = juce::jmin (found + 1, wanted);
+    }
+
+    for (int i = 0; i < found; ++i)
+    {
+        auto k = bins[(size_t) i];
+        float a, b, c;
+
+        if (method == Interpolation::gaussian)
+        {
+            a = juce::Decibels::gainToDecibels (magnitudes[k - 1]);
+            b = juce::Decibels::gainToDecibels (magnitudes[k]);
+            c = juce::Decibels::gainToDecibels (magnitudes[k + 1]);
+        }
+        else
+        {
+            a = magnitudes[k - 1];
+            b = magnitudes[k];
+            c = magnitudes[k + 1];
+        }
+
+        // Vertex of the parabola through the three points, as an offset from k in bins
+        auto denominator = a - 2.0f * b + c;
+        auto offset = denominator < 0.0f ? juce::jlimit (-0.5f, 0.5f, 0.5f * (a - c) / denominator) : 0.0f;
+        auto peakValue = b - 0.25f * (a - c) * offset;
+
+        auto& peak = result.peaks[(size_t) i];
+        peak.frequency = ((float) k + offset) * binWidth;
+        peak.level = (method == Interpolation::gaussian ? peakValue : juce::Decibels::gainToDecibels (peakValue))
+                       - referenceDb;
+    }
+
+    result.numPeaks = found;
+}
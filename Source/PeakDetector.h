@@ -0,0 +1,66 @@
+/*
+==============================================================================
+
+    PeakDetector.h
+    Created: 19 Oct 2026 3:58:18am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Finds the strongest local maxima in a magnitude spectrum and refines each
+    one to a sub-bin frequency and level by fitting a parabola through the peak
+    bin and its two neighbours. Fitting the linear magnitudes is the plain
+    quadratic estimate, fitting the log magnitudes is the Gaussian one, which is
+    noticeably more accurate for the Hann window we use.
+
+    Meant to run once per FFT frame on the audio thread, so nothing allocates.
+*/
+
+class PeakDetector
+{
+public:
+    enum class Interpolation
+    {
+        quadratic = 0,
+        gaussian
+    };
+
+    struct Peak
+    {
+        float frequency = 0.0f; // Hz
+        float level = 0.0f;     // dB, same scale as the spectrum display
+    };
+
+    static constexpr int maxPeaks = 8;
+
+    struct Result
+    {
+        std::array<Peak, maxPeaks> peaks;
+        int numPeaks = 0;
+    };
+
+    PeakDetector() = default;
+
+    void setNumPeaks (int newNumPeaks)              { numPeaks = juce::jlimit (0, maxPeaks, newNumPeaks); }
+    void setThreshold (float newThresholdDb)        { thresholdDb = newThresholdDb; }
+    void setInterpolation (Interpolation newMethod) { interpolation = newMethod; }
+
+    // magnitudes holds numBins bins of an fftSize-point transform. Levels are
+    // reported relative to referenceDb, the display uses the FFT size for this.
+    void process (const float* magnitudes, int numBins, int fftSize,
+                  double sampleRate, float referenceDb, Result& result) const;
+
+private:
+    std::atomic<int> numPeaks { 0 };
+    std::atomic<float> thresholdDb { -70.0f };
+    std::atomic<Interpolation> interpolation { Interpolation::gaussian };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakDetector)
+};
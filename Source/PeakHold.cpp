@@ -0,0 +1,74 @@
+/*
+==============================================================================
+
+    PeakHold.cpp
+    Created: 19 Oct 2026 4:45:55am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "PeakHold.h"
+
+//==============================================================================
+PeakHold::PeakHold (int numBins)
+    : levels ((size_t) numBins, 0.0f),
+      framesLeft ((size_t) numBins, 0.0f)
+{
+    jassert (numBins > 0);
+}
+
+void PeakHold::prepare (double sampleRate, int hopSize)
+{
+    framesPerSecond = sampleRate / hopSize;
+    resetRequested = true;
+}
+
+void PeakHold::setHoldSeconds (float newSeconds)
+{
+    holdSeconds = juce::jmax (0.0f, newSeconds);
+}
+
+void PeakHold::setFallRate (float newDbPerSecond)
+{
+    fallRate = juce::jmax (0.0f, newDbPerSecond);
+}
+
+void PeakHold::setInfinite (bool shouldHoldForever)
+{
+    infinite = shouldHoldForever;
+}
+
+void PeakHold::reset()
+{
+    resetRequested = true;
+}
+
+void PeakHold::process (const float* magnitudes) noexcept
+{
+    if (resetRequested.exchange (false))
+    {
+        std::fill (levels.begin(), levels.end(), 0.0f);
+        std::fill (framesLeft.begin(), framesLeft.end(), 0.0f);
+    }
+
+    // Infinite hold is a fall of 0 dB, the timers then don't matter
+    auto holdFrames = (float) (holdSeconds.load() * framesPerSecond);
+    auto fall = infinite.load() ? 1.0f
+                                : (float) std::pow (10.0, -fallRate.load() / (20.0 * framesPerSecond));
+
+    auto* held = levels.data();
+    auto* timers = framesLeft.data();
+    auto numBins = (int) levels.size();
+
+    // Selects rather than branches, so the loop vectorises
+    for (int n = 0; n < numBins; ++n)
+    {
+        auto magnitude = magnitudes[n];
+        auto rising = magnitude >= held[n];
+        auto falling = timers[n] <= 0.0f;
+
+        held[n] = rising ? magnitude : (falling ? held[n] * fall : held[n]);
+        timers[n] = rising ? holdFrames : juce::jmax (0.0f, timers[n] - 1.0f);
+    }
+}
@@ -0,0 +1,60 @@
+/*
+==============================================================================
+
+    PeakHold.h
+    Created: 19 Oct 2026 4:45:55am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Per-bin peak hold for the spectrum outline. A bin's level jumps up to any
+    louder frame, stays there for the hold time and then falls at a fixed
+    rate in dB per second until something louder comes along. With infinite
+    hold it never falls, until reset.
+
+    The held levels and the frames each bin has left to hold are kept in two
+    separate arrays, and a frame updates both in one branch-free pass that the
+    compiler can vectorise.
+*/
+
+class PeakHold
+{
+public:
+    explicit PeakHold (int numBins);
+
+    // Frames come every hopSize samples
+    void prepare (double sampleRate, int hopSize);
+
+    // Any thread, picked up by the next frame
+    void setHoldSeconds (float newSeconds);
+    void setFallRate (float newDbPerSecond);
+    void setInfinite (bool shouldHoldForever);
+    void reset();
+
+    // Audio thread, once per frame of numBins magnitudes
+    void process (const float* magnitudes) noexcept;
+
+    // Held magnitudes, on the same scale as the ones passed to process()
+    const float* getLevels() const noexcept { return levels.data(); }
+    int getNumBins() const noexcept { return (int) levels.size(); }
+
+private:
+    std::vector<float> levels;
+    std::vector<float> framesLeft;
+
+    double framesPerSecond = 44100.0 / 2048.0;
+
+    std::atomic<float> holdSeconds { 2.0f };
+    std::atomic<float> fallRate { 20.0f };
+    std::atomic<bool> infinite { false };
+    std::atomic<bool> resetRequested { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PeakHold)
+};
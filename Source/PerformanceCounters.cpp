@@ -0,0 +1,194 @@
+/*
+==============================================================================
+
+    PerformanceCounters.cpp
+    Created: 19 Oct 2026 4:12:30am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "PerformanceCounters.h"
+
+#include <bit>
+
+//==============================================================================
+const char* PerformanceCounters::getStageName (Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::fifoIngest:      return "FIFO ingest";
+        case Stage::windowing:       return "Windowing";
+        case Stage::fft:             return "FFT";
+        case Stage::smoothing:       return "Smoothing";
+        case Stage::framePublish:    return "Frame publish";
+        case Stage::nextFrame:       return "Next frame";
+        case Stage::drawGrid:        return "Grid";
+        case Stage::drawOutline:     return "Outline";
+        case Stage::drawSpectrum:    return "Spectrum";
+        case Stage::drawMode:        return "Mode display";
+        case Stage::drawPercentiles: return "Percentiles";
+        case Stage::drawNoiseFloor:  return "Noise floor";
+        case Stage::paint:           return "Paint";
+        case Stage::numStages:
+        default:                     break;
+    }
+
+    return "";
+}
+
+const char* PerformanceCounters::getStageKey (Stage stage)
+{
+    switch (stage)
+    {
+        case Stage::fifoIngest:      return "fifoIngest";
+        case Stage::windowing:       return "windowing";
+        case Stage::fft:             return "fft";
+        case Stage::smoothing:       return "smoothing";
+        case Stage::framePublish:    return "framePublish";
+        case Stage::nextFrame:       return "drawNextFrameOfSpectrum";
+        case Stage::drawGrid:        return "drawGrid";
+        case Stage::drawOutline:     return "drawOutline";
+        case Stage::drawSpectrum:    return "drawSpectrum";
+        case Stage::drawMode:        return "drawMode";
+        case Stage::drawPercentiles: return "drawPercentiles";
+        case Stage::drawNoiseFloor:  return "drawNoiseFloor";
+        case Stage::paint:           return "paint";
+        case Stage::numStages:
+        default:                     break;
+    }
+
+    return "";
+}
+
+//==============================================================================
+int PerformanceCounters::getBucket (juce::uint64 nanoseconds) noexcept
+{
+    // Bucket 0 is everything under 64 ns, then four per octave
+    if (nanoseconds < 64)
+        return 0;
+
+    auto highestBit = (int) std::bit_width (nanoseconds) - 1;
+    auto quarter = (int) (nanoseconds >> (highestBit - 2)) & 3;
+
+    return juce::jmin (numBuckets - 1, (highestBit - 6) * 4 + quarter + 1);
+}
+
+juce::uint64 PerformanceCounters::getBucketUpperBound (int bucket) noexcept
+{
+    if (bucket == 0)
+        return 64;
+
+    auto highestBit = (bucket - 1) / 4 + 6;
+    auto quarter = (juce::uint64) ((bucket - 1) % 4);
+
+    return (5 + quarter) << (highestBit - 2);
+}
+
+void PerformanceCounters::record (Stage stage, juce::int64 ticks) noexcept
+{
+    auto& histogram = histograms[(size_t) stage];
+    auto nanoseconds = (juce::uint64) juce::jmax (0.0, (double) ticks * nanosecondsPerTick);
+
+    // Single writer, so load-then-store is enough and cheaper than fetch_add
+    auto& bucket = histogram.buckets[(size_t) getBucket (nanoseconds)];
+    bucket.store (bucket.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    histogram.count.store (histogram.count.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if (nanoseconds > histogram.maxNanoseconds.load (std::memory_order_relaxed))
+        histogram.maxNanoseconds.store (nanoseconds, std::memory_order_relaxed);
+}
+
+//==============================================================================
+double PerformanceCounters::getPercentile (const Histogram& histogram, juce::uint64 total, double percentile) const
+{
+    if (total == 0)
+        return 0.0;
+
+    auto target = (juce::uint64) std::ceil (percentile * (double) total);
+    juce::uint64 seen = 0;
+
+    for (int b = 0; b < numBuckets; ++b)
+    {
+        seen += histogram.buckets[(size_t) b].load (std::memory_order_relaxed);
+
+        // Never report more than the slowest sample we actually saw
+        if (seen >= target)
+            return (double) juce::jmin (getBucketUpperBound (b), histogram.maxNanoseconds.load (std::memory_order_relaxed)) * 0.001;
+    }
+
+    return (double) histogram.maxNanoseconds.load (std::memory_order_relaxed) * 0.001;
+}
+
+PerformanceCounters::Summary PerformanceCounters::getSummary (Stage stage) const
+{
+    const auto& histogram = histograms[(size_t) stage];
+
+    // Add the buckets up rather than trusting count, they're read at slightly different times
+    juce::uint64 total = 0;
+
+    for (const auto& bucket : histogram.buckets)
+        total += bucket.load (std::memory_order_relaxed);
+
+    Summary summary;
+    summary.count = total;
+    summary.p50 = getPercentile (histogram, total, 0.5);
+    summary.p99 = getPercentile (histogram, total, 0.99);
+    summary.max = (double) histogram.maxNanoseconds.load (std::memory_order_relaxed) * 0.001;
+    return summary;
+}
+
+void PerformanceCounters::reset()
+{
+    for (auto& histogram : histograms)
+    {
+        for (auto& bucket : histogram.buckets)
+            bucket.store (0, std::memory_order_relaxed);
+
+        histogram.count.store (0, std::memory_order_relaxed);
+        histogram.maxNanoseconds.store (0, std::memory_order_relaxed);
+    }
+
+    droppedFrames.store (0, std::memory_order_relaxed);
+}
+
+//==============================================================================
+juce::var PerformanceCounters::toVar() const
+{
+    auto* stages = new juce::DynamicObject();
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        auto stage = static_cast<Stage> (s);
+        auto summary = getSummary (stage);
+        const auto& histogram = histograms[(size_t) s];
+
+        // Only the occupied buckets, as [upper bound in ns, count] pairs
+        juce::Array<juce::var> buckets;
+
+        for (int b = 0; b < numBuckets; ++b)
+            if (auto n = histogram.buckets[(size_t) b].load (std::memory_order_relaxed); n > 0)
+                buckets.add (juce::Array<juce::var> { (juce::int64) getBucketUpperBound (b), (juce::int64) n });
+
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty ("thread", isAudioStage (stage) ? "audio" : "message");
+        entry->setProperty ("count", (juce::int64) summary.count);
+        entry->setProperty ("p50Us", summary.p50);
+        entry->setProperty ("p99Us", summary.p99);
+        entry->setProperty ("maxUs", summary.max);
+        entry->setProperty ("buckets", buckets);
+
+        stages->setProperty (getStageKey (stage), juce::var (entry));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty ("stages", juce::var (stages));
+    root->setProperty ("framesPublished", (juce::int64) getSummary (Stage::framePublish).count);
+    root->setProperty ("framesDropped", (juce::int64) getNumDroppedFrames());
+    return juce::var (root);
+}
+
+juce::String PerformanceCounters::toJSON() const
+{
+    return juce::JSON::toString (toVar());
+}
@@ -0,0 +1,129 @@
+/*
+==============================================================================
+
+    PerformanceCounters.h
+    Created: 19 Oct 2026 4:12:30am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Timing histograms for each stage of the analyzer, DSP and UI, so we can
+    tell where the time goes when someone says it's heavy.
+
+    Every stage is only ever timed from one thread (the audio stages from the
+    audio thread, the drawing from the message thread), so each histogram has a
+    single writer and its buckets are plain relaxed atomics. Recording a sample
+    is two tick reads and one increment. Readers on any thread get a slightly
+    fuzzy but never torn picture.
+
+    Buckets are log-spaced with four per octave, from 64 ns up to about a
+    second, so the percentiles are good to within about 20 %.
+*/
+
+class PerformanceCounters
+{
+public:
+    enum class Stage
+    {
+        // Audio thread
+        fifoIngest = 0,
+        windowing,
+        fft,
+        smoothing,
+        framePublish,
+
+        // Message thread
+        nextFrame,
+        drawGrid,
+        drawOutline,
+        drawSpectrum,
+        drawMode,           // Whatever the other display modes draw instead of the spectrum
+        drawPercentiles,
+        drawNoiseFloor,
+        paint,
+
+        numStages
+    };
+
+    static constexpr int numStages = (int) Stage::numStages;
+
+    static const char* getStageName (Stage stage);  // For display
+    static const char* getStageKey (Stage stage);   // For the JSON
+    static bool isAudioStage (Stage stage)          { return stage <= Stage::framePublish; }
+
+    struct Summary
+    {
+        juce::uint64 count = 0;
+        double p50 = 0.0;   // All in microseconds
+        double p99 = 0.0;
+        double max = 0.0;
+    };
+
+    void record (Stage stage, juce::int64 ticks) noexcept;
+
+    // Frames the editor missed because it hadn't taken the previous one yet.
+    // They're still analysed and exported. Audio thread only, like the audio stages.
+    void countDroppedFrame() noexcept
+    {
+        droppedFrames.store (droppedFrames.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    juce::uint64 getNumDroppedFrames() const noexcept { return droppedFrames.load (std::memory_order_relaxed); }
+
+    Summary getSummary (Stage stage) const;
+
+    // Not synchronised with the writers, a sample landing mid-reset may survive it
+    void reset();
+
+    juce::var toVar() const;
+    juce::String toJSON() const;
+
+    //==============================================================================
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer (PerformanceCounters& c, Stage s) noexcept
+            : counters (c), stage (s), start (juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedTimer() noexcept
+        {
+            counters.record (stage, juce::Time::getHighResolutionTicks() - start);
+        }
+
+    private:
+        PerformanceCounters& counters;
+        const Stage stage;
+        const juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+private:
+    static constexpr int numBuckets = 104;
+
+    static int getBucket (juce::uint64 nanoseconds) noexcept;
+    static juce::uint64 getBucketUpperBound (int bucket) noexcept;
+
+    struct Histogram
+    {
+        std::array<std::atomic<juce::uint32>, numBuckets> buckets {};
+        std::atomic<juce::uint64> count { 0 };
+        std::atomic<juce::uint64> maxNanoseconds { 0 };
+    };
+
+    double getPercentile (const Histogram& histogram, juce::uint64 total, double percentile) const;
+
+    std::array<Histogram, numStages> histograms;
+    std::atomic<juce::uint64> droppedFrames { 0 };
+
+    const double nanosecondsPerTick = 1.0e9 / (double) juce::Time::getHighResolutionTicksPerSecond();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceCounters)
+};
@@ -0,0 +1,97 @@
+/*
+==============================================================================
+
+    PerformanceOverlay.cpp
+    Created: 19 Oct 2026 4:12:30am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "PerformanceOverlay.h"
+
+//==============================================================================
+PerformanceOverlay::PerformanceOverlay (PerformanceCounters& c)
+    : counters (c)
+{
+    setTooltip ("Click to copy the timings as JSON, right-click to reset them");
+}
+
+PerformanceOverlay::~PerformanceOverlay()
+{
+    stopTimer();
+}
+
+void PerformanceOverlay::visibilityChanged()
+{
+    // No point refreshing a table nobody can see
+    if (isVisible())
+        startTimerHz (4);
+    else
+        stopTimer();
+}
+
+void PerformanceOverlay::timerCallback()
+{
+    repaint();
+}
+
+void PerformanceOverlay::mouseUp (const juce::MouseEvent& e)
+{
+    if (e.mods.isPopupMenu())
+        counters.reset();
+    else
+        juce::SystemClipboard::copyTextToClipboard (counters.toJSON());
+
+    repaint();
+}
+
+void PerformanceOverlay::paint (juce::Graphics& g)
+{
+    g.setColour (juce::Colours::black.withAlpha (0.75f));
+    g.fillRoundedRectangle (getLocalBounds().toFloat(), 4.0f);
+
+    g.setFont (juce::Font (juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+
+    auto rowHeight = 16;
+    auto area = getLocalBounds().reduced (6, 4);
+
+    auto drawRow = [&] (juce::Colour colour, const juce::String& name, const juce::String& p50,
+                        const juce::String& p99, const juce::String& max, const juce::String& count)
+    {
+        auto row = area.removeFromTop (rowHeight);
+        g.setColour (colour);
+        g.drawText (name, row.removeFromLeft (90), juce::Justification::centredLeft);
+        g.drawText (p50, row.removeFromLeft (48), juce::Justification::centredRight);
+        g.drawText (p99, row.removeFromLeft (48), juce::Justification::centredRight);
+        g.drawText (max, row.removeFromLeft (48), juce::Justification::centredRight);
+        g.drawText (count, row, juce::Justification::centredRight);
+    };
+
+    drawRow (juce::Colours::grey, "us", "p50", "p99", "max", "count");
+
+    for (int s = 0; s < PerformanceCounters::numStages; ++s)
+    {
+        auto stage = static_cast<PerformanceCounters::Stage> (s);
+        auto summary = counters.getSummary (stage);
+
+        // DSP stages in one colour and UI stages in another, that's the question usually asked
+        auto colour = PerformanceCounters::isAudioStage (stage) ? juce::Colours::lightgreen : juce::Colours::lightskyblue;
+
+        drawRow (colour,
+                 PerformanceCounters::getStageName (stage),
+                 juce::String (summary.p50, 1),
+                 juce::String (summary.p99, 1),
+                 juce::String (summary.max, 1),
+                 juce::String ((juce::int64) summary.count));
+    }
+
+    auto published = counters.getSummary (PerformanceCounters::Stage::framePublish).count;
+    auto dropped = counters.getNumDroppedFrames();
+
+    area.removeFromTop (rowHeight / 2);
+    g.setColour (dropped > 0 ? juce::Colours::orange : juce::Colours::white);
+    g.drawText ("Frames " + juce::String ((juce::int64) published) + " published, "
+                    + juce::String ((juce::int64) dropped) + " dropped",
+                area.removeFromTop (rowHeight), juce::Justification::centredLeft);
+}
@@ -0,0 +1,44 @@
+/*
+==============================================================================
+
+    PerformanceOverlay.h
+    Created: 19 Oct 2026 4:12:30am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PerformanceCounters.h"
+
+//==============================================================================
+/*
+    Table of the stage timings drawn over the analyzer. Clicking it copies the
+    full histograms to the clipboard as JSON, right-clicking resets them.
+*/
+
+class PerformanceOverlay  : public juce::Component,
+                            public juce::SettableTooltipClient,
+                            private juce::Timer
+{
+public:
+    explicit PerformanceOverlay (PerformanceCounters& counters);
+    ~PerformanceOverlay() override;
+
+    void paint (juce::Graphics& g) override;
+    void mouseUp (const juce::MouseEvent& e) override;
+    void visibilityChanged() override;
+
+    // Size the table needs
+    static constexpr int preferredWidth = 290;
+    static constexpr int preferredHeight = 16 * (PerformanceCounters::numStages + 3);
+
+private:
+    void timerCallback() override;
+
+    PerformanceCounters& counters;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceOverlay)
+};
@@ -10,7 +10,8 @@ PluginEditor::PluginEditor (PluginProcessor& p, juce::AudioProcessorValueTreeSta
       undoManager (um),
       apvts (vts),
       scope (p, fs),
-      testDial  (*vts.getParameter ("smoothTime"),  &um)
+      testDial  (*vts.getParameter ("smoothTime"),  &um),
+      performanceOverlay (p.getPerformanceCounters())
 {
     setWantsKeyboardFocus (true);
     juce::ignoreUnused (processorRef);
@@ -18,7 +19,11 @@ PluginEditor::PluginEditor (PluginProcessor& p, juce::AudioProcessorValueTreeSta
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
     setOpaque(true);
-    setSize (500, 400);
+
+    // Resizable up to a full 4K screen, never smaller than the original layout
+    setResizable (true, true);
+    setResizeLimits (designWidth, designHeight, 3840, 2160);
+    setSize (designWidth, designHeight);
     addAndMakeVisible(scope);
 
     smoothTimeDial.setSliderStyle (juce::Slider::Rotary);
@@ -31,12 +36,278 @@ PluginEditor::PluginEditor (PluginProcessor& p, juce::AudioProcessorValueTreeSta
     testDial.setInterval (5.0f);
     testDial.setFineInterval (1.0f);
 
+    // Items have to be there before the attachment syncs the selection
+    avgModeBox.addItemList (apvts.getParameter ("avgMode")->getAllValueStrings(), 1);
+    avgModeAttachment = std::make_unique<ComboBoxAttachment> (apvts, "avgMode", avgModeBox);
+
+    avgFramesSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    avgFramesSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 30, 20);
+    avgFramesAttachment = std::make_unique<SliderAttachment> (apvts, "avgFrames", avgFramesSlider);
+
+    resetAverageButton.setTooltip ("Start the averages, percentiles and held peaks over");
+    resetAverageButton.onClick = [this] { processorRef.resetAveraging(); };
+
+    captureButton.setTooltip ("Save the last few seconds of input to a WAV file, or capture automatically");
+    captureButton.onClick = [this] { showCaptureMenu(); };
+    processorRef.getCaptureRecorder().addChangeListener (this);
+
+    displayModeBox.addItemList (apvts.getParameter ("displayMode")->getAllValueStrings(), 1);
+    displayModeAttachment = std::make_unique<ComboBoxAttachment> (apvts, "displayMode", displayModeBox);
+    displayModeBox.onChange = [this]
+    {
+        updateModeControls();
+        scope.repaint();
+    };
+
+    findDelayButton.setTooltip ("Find the delay between the sidechain reference and the input");
+    findDelayButton.onClick = [this] { processorRef.findSidechainDelay(); };
+
+    filterbankButton.setTooltip ("Measure the bands with a filterbank rather than from the FFT, truer at low frequencies");
+    filterbankAttachment = std::make_unique<ButtonAttachment> (apvts, "rtaFilterbank", filterbankButton);
+
+    flatTopButton.setTooltip ("Measure harmonics through a flat-top window, for exact levels, rather than Blackman-Harris");
+    flatTopAttachment = std::make_unique<ButtonAttachment> (apvts, "flatTopWindow", flatTopButton);
+
+    phaseLaneAttachment = std::make_unique<ButtonAttachment> (apvts, "phaseLane", phaseLaneButton);
+    phaseLaneButton.onClick = [this] { scope.repaint(); };
+
+    pauseButton.setTooltip ("Freeze the display, then drag or scroll over it to go back in time");
+    pauseButton.onClick = [this] { scope.setPaused (pauseButton.getToggleState()); };
+
+    exportButton.setTooltip ("Share the spectrum with external tools through shared memory");
+    exportAttachment = std::make_unique<ButtonAttachment> (apvts, "shmExport", exportButton);
+
+    referenceBox.setEditableText (true);
+    referenceBox.setTooltip ("Reference slot, type to rename it");
+    referenceBox.onChange = [this]
+    {
+        auto id = referenceBox.getSelectedId();
+
+        // No id means the text was edited, which renames the slot we were on
+        if (id == 0)
+            processorRef.getReferences().setName (selectedReference, referenceBox.getText());
+        else
+            selectedReference = id - 1;
+
+        if (differenceButton.getToggleState())
+            scope.setDifferenceSlot (selectedReference);
+    };
+    refreshReferenceBox();
+    processorRef.getReferences().addChangeListener (this);
+
+    storeReferenceButton.setTooltip ("Freeze the spectrum on display into the selected slot");
+    storeReferenceButton.onClick = [this] { scope.storeReference (selectedReference, {}); };
+    clearReferenceButton.onClick = [this] { processorRef.getReferences().clear (selectedReference); };
+
+    differenceButton.setTooltip ("Show the live spectrum minus the selected reference");
+    differenceButton.onClick = [this] { scope.setDifferenceSlot (differenceButton.getToggleState() ? selectedReference : -1); };
+
+    weightingBox.addItemList (apvts.getParameter ("weighting")->getAllValueStrings(), 1);
+    weightingBox.setTooltip ("Frequency weighting: Z is flat, A and C follow IEC 61672");
+    weightingAttachment = std::make_unique<ComboBoxAttachment> (apvts, "weighting", weightingBox);
+
+    tiltSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    tiltSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 40, 20);
+    tiltSlider.setTextValueSuffix (" dB");
+    tiltSlider.setTooltip ("Display tilt in dB per octave around 1 kHz, 3 shows pink noise flat");
+    tiltAttachment = std::make_unique<SliderAttachment> (apvts, "tilt", tiltSlider);
+
+    percentileBox.addItemList (apvts.getParameter ("percentiles")->getAllValueStrings(), 1);
+    percentileBox.setTooltip ("Show L10, L50 and L90, the levels exceeded 10, 50 and 90 % of the time, over this long. Reset starts them over.");
+    percentileAttachment = std::make_unique<ComboBoxAttachment> (apvts, "percentiles", percentileBox);
+    percentileBox.onChange = [this] { scope.repaint(); };
+
+    noiseFloorBox.addItemList (apvts.getParameter ("noiseFloor")->getAllValueStrings(), 1);
+    noiseFloorBox.setTooltip ("Show each bin's noise floor, the quietest it has been over this long. Reset starts it over.");
+    noiseFloorAttachment = std::make_unique<ComboBoxAttachment> (apvts, "noiseFloor", noiseFloorBox);
+    noiseFloorBox.onChange = [this] { scope.repaint(); };
+
+    snrButton.setTooltip ("Shade between the noise floor and the spectrum by how far it clears the floor");
+    snrAttachment = std::make_unique<ButtonAttachment> (apvts, "snrShading", snrButton);
+
+    peakHoldSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    peakHoldSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 40, 20);
+    peakHoldSlider.setTextValueSuffix (" s");
+    peakHoldSlider.setTooltip ("How long the outline holds each bin's peak before it falls");
+    peakHoldAttachment = std::make_unique<SliderAttachment> (apvts, "peakHold", peakHoldSlider);
+
+    peakFallSlider.setSliderStyle (juce::Slider::LinearHorizontal);
+    peakFallSlider.setTextBoxStyle (juce::Slider::TextBoxRight, false, 55, 20);
+    peakFallSlider.setTextValueSuffix (" dB/s");
+    peakFallSlider.setTooltip ("How fast the held peaks fall once the hold time is up");
+    peakFallAttachment = std::make_unique<SliderAttachment> (apvts, "peakFall", peakFallSlider);
+
+    infiniteHoldButton.setTooltip ("Hold the peaks until Reset");
+    infiniteHoldAttachment = std::make_unique<ButtonAttachment> (apvts, "infiniteHold", infiniteHoldButton);
+
+    trackerTargetsEditor.setTooltip ("Frequencies to track in Hz, separated by spaces or commas");
+    trackerTargetsEditor.setJustification (juce::Justification::centredRight);
+    trackerTargetsEditor.onReturnKey = [this] { applyTrackerTargets(); };
+    trackerTargetsEditor.onFocusLost = [this] { applyTrackerTargets(); };
+
+    performanceButton.setTooltip ("Show how long each stage of the analysis and drawing takes");
+    performanceButton.onClick = [this] { performanceOverlay.setVisible (performanceButton.getToggleState()); };
+
     addAndMakeVisible(smoothTimeDial);
     addAndMakeVisible(testDial);
+    addAndMakeVisible(avgModeBox);
+    addAndMakeVisible(avgFramesSlider);
+    addAndMakeVisible(resetAverageButton);
+    addAndMakeVisible(captureButton);
+    addAndMakeVisible(displayModeBox);
+    addAndMakeVisible(findDelayButton);
+    addChildComponent(filterbankButton);
+    addChildComponent(flatTopButton);
+    addAndMakeVisible(phaseLaneButton);
+    addAndMakeVisible(pauseButton);
+    addAndMakeVisible(exportButton);
+    addAndMakeVisible(performanceButton);
+    addAndMakeVisible(referenceBox);
+    addAndMakeVisible(storeReferenceButton);
+    addAndMakeVisible(clearReferenceButton);
+    addAndMakeVisible(differenceButton);
+    addChildComponent(performanceOverlay);
+    addChildComponent(trackerTargetsEditor);
+    addChildComponent(weightingBox);
+    addChildComponent(tiltSlider);
+    addChildComponent(percentileBox);
+    addChildComponent(noiseFloorBox);
+    addChildComponent(snrButton);
+    addChildComponent(peakHoldSlider);
+    addChildComponent(peakFallSlider);
+    addChildComponent(infiniteHoldButton);
+
+    updateModeControls();
 }
 
 PluginEditor::~PluginEditor()
 {
+    processorRef.getReferences().removeChangeListener (this);
+    processorRef.getCaptureRecorder().removeChangeListener (this);
+}
+
+void PluginEditor::refreshReferenceBox()
+{
+    auto& references = processorRef.getReferences();
+    referenceBox.clear (juce::dontSendNotification);
+
+    for (int s = 0; s < ReferenceSnapshots::numSlots; ++s)
+        referenceBox.addItem (references.getName (s), s + 1);
+
+    referenceBox.setSelectedId (selectedReference + 1, juce::dontSendNotification);
+}
+
+void PluginEditor::updateModeControls()
+{
+    auto mode = processorRef.getDisplayMode();
+    auto rtaMode = PluginProcessor::isRtaMode (mode);
+    auto harmonicMode = mode == PluginProcessor::DisplayMode::harmonics;
+
+    findDelayButton.setVisible (not rtaMode && not harmonicMode);
+    filterbankButton.setVisible (rtaMode);
+    flatTopButton.setVisible (harmonicMode);
+    phaseLaneButton.setVisible (not harmonicMode);
+
+    if (mode == PluginProcessor::DisplayMode::tracker)
+    {
+        juce::StringArray tokens;
+
+        for (auto frequency : processorRef.getToneTracker().getTargets())
+            tokens.add (juce::String (frequency));
+
+        trackerTargetsEditor.setText (tokens.joinIntoString (", "), false);
+    }
+
+    trackerTargetsEditor.setVisible (mode == PluginProcessor::DisplayMode::tracker);
+
+    // Weighting means nothing to the transfer function, distortion or tracker readings
+    auto weighted = mode == PluginProcessor::DisplayMode::spectrum || rtaMode;
+    weightingBox.setVisible (weighted);
+    tiltSlider.setVisible (weighted);
+    percentileBox.setVisible (mode == PluginProcessor::DisplayMode::spectrum);
+    noiseFloorBox.setVisible (mode == PluginProcessor::DisplayMode::spectrum);
+    snrButton.setVisible (mode == PluginProcessor::DisplayMode::spectrum);
+
+    auto outlined = mode == PluginProcessor::DisplayMode::spectrum || harmonicMode;
+    peakHoldSlider.setVisible (outlined);
+    peakFallSlider.setVisible (outlined);
+    infiniteHoldButton.setVisible (outlined);
+}
+
+void PluginEditor::applyTrackerTargets()
+{
+    juce::Array<float> frequencies;
+
+    for (const auto& token : juce::StringArray::fromTokens (trackerTargetsEditor.getText(), " ,;", ""))
+        if (auto frequency = token.getFloatValue(); frequency > 0.0f)
+            frequencies.add (frequency);
+
+    processorRef.setTrackerTargets (frequencies);
+}
+
+void PluginEditor::showCaptureMenu()
+{
+    auto& recorder = processorRef.getCaptureRecorder();
+    auto* seconds = apvts.getParameter ("captureSeconds");
+    auto* trigger = apvts.getParameter ("captureTrigger");
+    auto* threshold = apvts.getParameter ("captureThreshold");
+
+    auto isSetTo = [] (juce::RangedAudioParameter* parameter, float value)
+    {
+        return std::abs (parameter->convertFrom0to1 (parameter->getValue()) - value) < 0.5f;
+    };
+
+    auto setTo = [] (juce::RangedAudioParameter* parameter, float value)
+    {
+        return [parameter, value] { parameter->setValueNotifyingHost (parameter->convertTo0to1 (value)); };
+    };
+
+    juce::PopupMenu lengthMenu, triggerMenu, thresholdMenu;
+
+    for (auto length : { 5.0f, 10.0f, 20.0f, 30.0f })
+        lengthMenu.addItem (juce::String ((int) length) + " s", true, isSetTo (seconds, length), setTo (seconds, length));
+
+    auto triggers = trigger->getAllValueStrings();
+
+    for (int t = 0; t < triggers.size(); ++t)
+        triggerMenu.addItem (triggers[t], true, isSetTo (trigger, (float) t), setTo (trigger, (float) t));
+
+    for (auto level : { -24.0f, -12.0f, -6.0f, -3.0f, -1.0f })
+        thresholdMenu.addItem (juce::String ((int) level) + " dBFS", true, isSetTo (threshold, level), setTo (threshold, level));
+
+    auto length = juce::roundToInt (seconds->convertFrom0to1 (seconds->getValue()));
+    auto lastFile = recorder.getLastFile();
+
+    juce::PopupMenu menu;
+
+    // Only the first two channels of a wider input are kept
+    if (auto channelsLabel = processorRef.getAnalysedChannelsLabel(); channelsLabel.isNotEmpty())
+        menu.addSectionHeader (channelsLabel);
+
+    menu.addItem ("Save the last " + juce::String (length) + " s", not recorder.isWriting(), false, [&recorder] { recorder.capture(); });
+    menu.addItem ("Show the last capture", lastFile.existsAsFile(), false, [lastFile] { lastFile.revealToUser(); });
+    menu.addSeparator();
+    menu.addSubMenu ("Length", lengthMenu);
+    menu.addSubMenu ("Trigger", triggerMenu);
+    menu.addSubMenu ("Level threshold", thresholdMenu, isSetTo (trigger, (float) CaptureRecorder::Trigger::level));
+
+    menu.showMenuAsync (juce::PopupMenu::Options().withTargetComponent (captureButton));
+}
+
+void PluginEditor::changeListenerCallback (juce::ChangeBroadcaster* source)
+{
+    auto& recorder = processorRef.getCaptureRecorder();
+
+    // A capture has been written, or has failed
+    if (source == &recorder)
+    {
+        auto error = recorder.getLastError();
+        captureButton.setTooltip (error.isNotEmpty() ? error : "Saved " + recorder.getLastFile().getFullPathName());
+        return;
+    }
+
+    // Names may have changed, from the box itself or from a restored session
+    refreshReferenceBox();
 }
 
 //==============================================================================
@@ -49,16 +320,71 @@ void PluginEditor::paint (juce::Graphics& g)
 
 void PluginEditor::resized()
 {
-    auto border = 20;
+    // Everything is laid out on the 500 x 460 design, then scaled. The
+    // controls grow with the height up to twice their size, and the scope gets
+    // whatever is left.
+    auto scale = juce::jlimit (1.0f, 2.0f, (float) getHeight() / (float) designHeight);
+    auto scaled = [scale] (int value) { return juce::roundToInt ((float) value * scale); };
+
+    auto border = scaled (20);
 
     // lay out the positions of your components
     juce::Rectangle<int> r = getLocalBounds();
-    scope.setBounds(r.reduced (border).withTrimmedBottom (border * 4));
+    auto controlArea = r.removeFromBottom (scaled (designHeight - 300));
+    scope.setBounds (r.withTrimmedTop (border).reduced (border, 0));
 
-    auto dialArea = r.withTrimmedTop(15 * border);
+    auto dialArea = controlArea;
     smoothTimeDial.setBounds (dialArea);
 
-    testDial.setBounds  (325,  300,  80, 95);
+    // Design x positions are kept relative to the left edge, the middle or the right
+    // edge, so each group of controls stays together as the window widens
+    enum class Anchor { left, centre, right };
+
+    auto place = [&] (juce::Component& c, Anchor anchor, int x, int y, int w, int h)
+    {
+        auto left = anchor == Anchor::left   ? controlArea.getX() + scaled (x)
+                  : anchor == Anchor::centre ? controlArea.getCentreX() + scaled (x - designWidth / 2)
+                                             : controlArea.getRight() - scaled (designWidth - x);
+
+        c.setBounds (left, controlArea.getY() + scaled (y - 300), scaled (w), scaled (h));
+    };
+
+    place (testDial,           Anchor::centre, 325, 300,  80, 95);
+
+    place (avgModeBox,         Anchor::left,    20, 310, 110, 22);
+    place (resetAverageButton, Anchor::left,   135, 310,  50, 22);
+    place (avgFramesSlider,    Anchor::left,    20, 340, 110, 22);
+    place (captureButton,      Anchor::left,   135, 340,  50, 22);
+    place (displayModeBox,     Anchor::left,    20, 370, 110, 22);
+    place (findDelayButton,    Anchor::left,   135, 370,  50, 22);
+    place (filterbankButton,   Anchor::left,   135, 370,  50, 22);
+    place (flatTopButton,      Anchor::left,   135, 370,  50, 22);
+    place (phaseLaneButton,    Anchor::right,  410, 310,  80, 22);
+    place (pauseButton,        Anchor::right,  410, 340,  80, 22);
+    place (exportButton,       Anchor::right,  410, 370,  80, 22);
+    place (performanceButton,  Anchor::centre, 190, 370,  60, 22);
+    place (referenceBox,       Anchor::centre, 190, 310, 125, 22);
+    place (storeReferenceButton, Anchor::centre, 190, 340, 60, 22);
+    place (clearReferenceButton, Anchor::centre, 255, 340, 60, 22);
+    place (differenceButton,   Anchor::centre, 255, 370,  60, 22);
+
+    // Display options for the current mode, in two rows of their own so the
+    // scope's corners stay free for the readouts and legends drawn there
+    place (weightingBox,       Anchor::left,    20, 400,  50, 22);
+    place (tiltSlider,         Anchor::left,    75, 400, 130, 22);
+    place (percentileBox,      Anchor::left,   210, 400,  75, 22);
+    place (noiseFloorBox,      Anchor::left,   290, 400,  70, 22);
+    place (snrButton,          Anchor::left,   365, 400,  50, 22);
+    place (peakHoldSlider,     Anchor::left,    20, 430, 130, 22);
+    place (peakFallSlider,     Anchor::left,   155, 430, 145, 22);
+    place (infiniteHoldButton, Anchor::left,   305, 430,  50, 22);
+
+    performanceOverlay.setBounds (scope.getBounds().reduced (4).removeFromTop (PerformanceOverlay::preferredHeight)
+                                                   .removeFromLeft (PerformanceOverlay::preferredWidth));
+
+    // Clear of the level meters down the scope's right-hand side
+    auto cornerArea = scope.getBounds().reduced (4).withTrimmedRight (56).removeFromTop (scaled (22));
+    trackerTargetsEditor.setBounds (cornerArea.withLeft (cornerArea.getRight() - scaled (160)));
 }
 
 bool PluginEditor::keyPressed (const juce::KeyPress& key)
@@ -2,9 +2,11 @@
 
 #include "PluginProcessor.h"
 #include "Dial.h"
+#include "PerformanceOverlay.h"
 
 //==============================================================================
-class PluginEditor : public juce::AudioProcessorEditor
+class PluginEditor : public juce::AudioProcessorEditor,
+                     private juce::ChangeListener
 
 {
 public:
@@ -21,8 +23,14 @@ public:
     bool keyPressed (const juce::KeyPress& key) override;
 
     typedef juce::AudioProcessorValueTreeState::SliderAttachment SliderAttachment;
+    typedef juce::AudioProcessorValueTreeState::ComboBoxAttachment ComboBoxAttachment;
+    typedef juce::AudioProcessorValueTreeState::ButtonAttachment ButtonAttachment;
 
 private:
+    // Size the layout was designed at, everything scales from here
+    static constexpr int designWidth = 500;
+    static constexpr int designHeight = 460;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     PluginProcessor& processorRef;
@@ -31,10 +39,92 @@ private:
 
     Analyzer scope;
 
+    // Without one of these, none of the tooltips ever show
+    juce::TooltipWindow tooltipWindow { this };
+
     juce::Slider smoothTimeDial;
     std::unique_ptr<SliderAttachment> smoothTimeAttachment;
 
     Dial testDial;
 
+    // Averaging controls
+    juce::ComboBox avgModeBox;
+    std::unique_ptr<ComboBoxAttachment> avgModeAttachment;
+    juce::Slider avgFramesSlider;
+    std::unique_ptr<SliderAttachment> avgFramesAttachment;
+    juce::TextButton resetAverageButton { "Reset" };
+
+    // Saving the last few seconds of input, and the automatic triggers, from a menu
+    juce::TextButton captureButton { "Capture" };
+    void showCaptureMenu();
+
+    // Display mode and sidechain delay search
+    juce::ComboBox displayModeBox;
+    std::unique_ptr<ComboBoxAttachment> displayModeAttachment;
+    juce::TextButton findDelayButton { "Delay" };
+
+    // Filterbank instead of FFT bins for the RTA bands, in the Delay button's place
+    juce::ToggleButton filterbankButton { "IIR" };
+    std::unique_ptr<ButtonAttachment> filterbankAttachment;
+
+    // Flat-top rather than Blackman-Harris window for harmonics, in the same place
+    juce::ToggleButton flatTopButton { "Flat" };
+    std::unique_ptr<ButtonAttachment> flatTopAttachment;
+
+    juce::ToggleButton phaseLaneButton { "Phase" };
+    std::unique_ptr<ButtonAttachment> phaseLaneAttachment;
+
+    juce::ToggleButton pauseButton { "Pause" };
+
+    juce::ToggleButton exportButton { "Export" };
+    std::unique_ptr<ButtonAttachment> exportAttachment;
+
+    // Reference slots: pick one (type over its name to rename it), store the
+    // spectrum on display into it, clear it, or show live minus it
+    juce::ComboBox referenceBox;
+    juce::TextButton storeReferenceButton { "Store" };
+    juce::TextButton clearReferenceButton { "Clear" };
+    juce::ToggleButton differenceButton { "Diff" };
+    int selectedReference = 0;
+
+    void refreshReferenceBox();
+
+    // Shows the controls that go with the current display mode
+    void updateModeControls();
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
+
+    // Frequency weighting and tilt, in the display options row in the spectrum and RTA modes
+    juce::ComboBox weightingBox;
+    std::unique_ptr<ComboBoxAttachment> weightingAttachment;
+    juce::Slider tiltSlider;
+    std::unique_ptr<SliderAttachment> tiltAttachment;
+
+    // Percentile window, next to them in the spectrum mode
+    juce::ComboBox percentileBox;
+    std::unique_ptr<ComboBoxAttachment> percentileAttachment;
+
+    // Noise floor window and SNR shading, after the percentiles in the spectrum mode
+    juce::ComboBox noiseFloorBox;
+    std::unique_ptr<ComboBoxAttachment> noiseFloorAttachment;
+    juce::ToggleButton snrButton { "SNR" };
+    std::unique_ptr<ButtonAttachment> snrAttachment;
+
+    // Peak hold time, fall rate and infinite hold, in a second options row wherever the outline is drawn.
+    // The averaging Reset clears the held peaks too.
+    juce::Slider peakHoldSlider;
+    std::unique_ptr<SliderAttachment> peakHoldAttachment;
+    juce::Slider peakFallSlider;
+    std::unique_ptr<SliderAttachment> peakFallAttachment;
+    juce::ToggleButton infiniteHoldButton { "Hold" };
+    std::unique_ptr<ButtonAttachment> infiniteHoldAttachment;
+
+    // Tracker frequencies in Hz, over the scope's top-right corner in tracker mode
+    juce::TextEditor trackerTargetsEditor;
+    void applyTrackerTargets();
+
+    // Stage timings, hidden until asked for
+    juce::ToggleButton performanceButton { "Perf" };
+    PerformanceOverlay performanceOverlay;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginEditor)
 };
@@ -3,6 +3,41 @@
 
 static juce::Identifier fftID {"fftPlot"};
 static juce::String smoothTime{"smoothTime"}; // uniform initialization of juce::String
+static juce::String avgMode{"avgMode"};
+static juce::String avgFrames{"avgFrames"};
+static juce::String numPeaks{"numPeaks"};
+static juce::String displayMode{"displayMode"};
+static juce::String phaseLane{"phaseLane"};
+static juce::String shmExport{"shmExport"};
+static juce::String rtaFilterbank{"rtaFilterbank"};
+static juce::String flatTopWindow{"flatTopWindow"};
+static juce::String weightingCurve{"weighting"};
+static juce::String tilt{"tilt"};
+static juce::String percentileWindow{"percentiles"};
+static juce::String peakHoldTime{"peakHold"};
+static juce::String peakFallRate{"peakFall"};
+static juce::String infinitePeakHold{"infiniteHold"};
+static juce::String captureSeconds{"captureSeconds"};
+static juce::String captureTrigger{"captureTrigger"};
+static juce::String captureThreshold{"captureThreshold"};
+static juce::String noiseFloorWindow{"noiseFloor"};
+static juce::String snrShading{"snrShading"};
+
+// Seconds of programme for each percentileWindow choice after "Off", 0 for the whole session
+static double getPercentileWindowSeconds (int choice)
+{
+    const double seconds[] = { 0.0, 60.0, 300.0, 900.0, 0.0 };
+    return seconds[juce::jlimit (0, 4, choice)];
+}
+
+// Seconds the noise floor's minimum is taken over for each noiseFloorWindow choice after "Off"
+static double getNoiseFloorWindowSeconds (int choice)
+{
+    const double seconds[] = { 2.0, 2.0, 5.0, 20.0 };
+    return seconds[juce::jlimit (0, 3, choice)];
+}
+
+static juce::Identifier trackerTargets{"trackerTargets"}; // Not a parameter, a property of the state
 
 static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout()
 {
@@ -13,35 +48,171 @@ static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout
                                                             juce::NormalisableRange<float>(0, 500, 1),
                                                             250));
 
+    layout.add(std::make_unique<juce::AudioParameterChoice> (juce::ParameterID(avgMode, 1),
+                                                             "Averaging",
+                                                             juce::StringArray { "Exponential", "Linear", "Infinite" },
+                                                             0));
+
+    layout.add(std::make_unique<juce::AudioParameterInt> (juce::ParameterID(avgFrames, 1),
+                                                          "Average Frames",
+                                                          1,
+                                                          PluginProcessor::maxAverageFrames,
+                                                          8));
+
+    layout.add(std::make_unique<juce::AudioParameterInt> (juce::ParameterID(numPeaks, 1),
+                                                          "Peak Labels",
+                                                          0,
+                                                          PeakDetector::maxPeaks,
+                                                          3));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice> (juce::ParameterID(displayMode, 1),
+                                                             "Display",
+                                                             juce::StringArray { "Spectrum", "Transfer Function", "RTA 1/3 Octave", "RTA 1/1 Octave", "Harmonics", "Tracker", "Channels", "Spectrogram" },
+                                                             0));
+
+    layout.add(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(phaseLane, 1),
+                                                           "Phase Lane",
+                                                           false));
+
+    layout.add(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(shmExport, 1),
+                                                           "Shared Memory Export",
+                                                           false));
+
+    layout.add(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(rtaFilterbank, 1),
+                                                           "RTA Filterbank",
+                                                           false));
+
+    layout.add(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(flatTopWindow, 1),
+                                                           "Flat Top Window",
+                                                           false));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice> (juce::ParameterID(weightingCurve, 1),
+                                                             "Weighting",
+                                                             juce::StringArray { "Z", "A", "C" },
+                                                             0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat> (juce::ParameterID(tilt, 1),
+                                                            "Tilt (dB/oct)",
+                                                            juce::NormalisableRange<float>(-6.0f, 6.0f, 0.5f),
+                                                            0.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice> (juce::ParameterID(percentileWindow, 1),
+                                                             "Percentiles",
+                                                             juce::StringArray { "Off", "1 min", "5 min", "15 min", "Session" },
+                                                             0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat> (juce::ParameterID(peakHoldTime, 1),
+                                                            "Peak Hold (s)",
+                                                            juce::NormalisableRange<float>(0.0f, 10.0f, 0.1f),
+                                                            2.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat> (juce::ParameterID(peakFallRate, 1),
+                                                            "Peak Fall (dB/s)",
+                                                            juce::NormalisableRange<float>(1.0f, 60.0f, 1.0f),
+                                                            20.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(infinitePeakHold, 1),
+                                                           "Infinite Peak Hold",
+                                                           false));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat> (juce::ParameterID(captureSeconds, 1),
+                                                            "Capture Length (s)",
+                                                            juce::NormalisableRange<float>(1.0f, (float) CaptureRecorder::maxSeconds, 1.0f),
+                                                            10.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice> (juce::ParameterID(captureTrigger, 1),
+                                                             "Capture Trigger",
+                                                             juce::StringArray { "Manual", "Level", "Onset" },
+                                                             0));
+
+    layout.add(std::make_unique<juce::AudioParameterFloat> (juce::ParameterID(captureThreshold, 1),
+                                                            "Capture Threshold (dBFS)",
+                                                            juce::NormalisableRange<float>(-60.0f, 0.0f, 1.0f),
+                                                            -6.0f));
+
+    layout.add(std::make_unique<juce::AudioParameterChoice> (juce::ParameterID(noiseFloorWindow, 1),
+                                                             "Noise Floor",
+                                                             juce::StringArray { "Off", "2 s", "5 s", "20 s" },
+                                                             0));
+
+    layout.add(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(snrShading, 1),
+                                                           "SNR Shading",
+                                                           false));
+
     return layout;
 }
 
 //==============================================================================
-PluginProcessor::PluginProcessor()
+PluginProcessor::PluginProcessor (Use use)
      : AudioProcessor (BusesProperties()
                      #if ! JucePlugin_IsMidiEffect
                       #if ! JucePlugin_IsSynth
                        .withInput  ("Input",  juce::AudioChannelSet::stereo(), true)
+                       .withInput  ("Sidechain", juce::AudioChannelSet::stereo(), false)
                       #endif
 // The analyzer has no outputs, so we can comment this out:
 //                       .withOutput ("Output", juce::AudioChannelSet::stereo(), true)
                      #endif
                        ),
+      analysisOnly (use == Use::analysisOnly),
       apvts (*this, &undoManager, "Parameters", createParameterLayout()),
-      forwardFFT (fftOrder),
-      window (fftSize, juce::dsp::WindowingFunction<float>::hann)
+      averager (fftSize / 2, maxAverageFrames),
+      transferFunction (fftOrder),
+      stereoCorrelation (fftOrder),
+      sharedExport (fftSize / 2, fftSize),
+      references (fftSize / 2),
+      history (fftSize / 2, use == Use::analysisOnly ? 0.0 : historySeconds, historyFramesPerSecond,
+               SpectralHistory::Precision::eightBit, true),
+      bandAnalyzer (fftSize),
+      onsetDetector (fftSize),
+      harmonicAnalyzer (fftSize),
+      weighting (fftSize),
+      multichannel (fftOrder),
+      percentiles (fftSize / 2, fftSize),
+      spectrogram (fftOrder),
+      peakHold (fftSize / 2),
+      noiseFloor (fftSize / 2)
 {
     apvts.addParameterListener (smoothTime, this);
+    apvts.addParameterListener (avgMode, this);
+    apvts.addParameterListener (avgFrames, this);
+    apvts.addParameterListener (numPeaks, this);
+    apvts.addParameterListener (shmExport, this);
+    apvts.addParameterListener (displayMode, this);
+    apvts.addParameterListener (rtaFilterbank, this);
+    apvts.addParameterListener (weightingCurve, this);
+    apvts.addParameterListener (tilt, this);
+    apvts.addParameterListener (percentileWindow, this);
+    apvts.addParameterListener (peakHoldTime, this);
+    apvts.addParameterListener (peakFallRate, this);
+    apvts.addParameterListener (infinitePeakHold, this);
+    apvts.addParameterListener (captureSeconds, this);
+    apvts.addParameterListener (captureTrigger, this);
+    apvts.addParameterListener (captureThreshold, this);
+    apvts.addParameterListener (noiseFloorWindow, this);
+    recorder.setDirectory (juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                               .getChildFile (juce::String (JucePlugin_Name) + " Captures"));
     for (int i = 0; i < 2 * fftSize; ++i)
-    {
         smoothedFftData[i] = 0;
-        maxSmoothedFftData[i] = 0;
-        fftData[i] = 0;
-    }
+    juce::zeromem (referenceFifo, sizeof (referenceFifo));
+    juce::zeromem (averagedFftData, sizeof (averagedFftData));
+    juce::zeromem (heldFftData, sizeof (heldFftData));
+    juce::zeromem (noiseFloorData, sizeof (noiseFloorData));
+    juce::zeromem (historyDb, sizeof (historyDb));
+
+    for (int channels = 1; channels <= AnalysisPipeline::maxChannels; ++channels)
+        pipelines[(size_t) channels - 1] = AnalysisPipeline::create (fftOrder, channels);
+
+    pipeline = pipelines.back().get();
+
+    // Mains hum and its first harmonics until someone picks something else
+    setTrackerTargets ({ 50.0f, 100.0f, 150.0f });
 }
 
 PluginProcessor::~PluginProcessor()
 {
+    cancelPendingUpdate();
+    sharedExport.close();
 }
 
 //==============================================================================
@@ -118,23 +289,74 @@ void PluginProcessor::prepareToPlay (double sampleRate, int samplesPerBlock)
 
     fs = sampleRate;
 
-    float upperLimit;
-    AudioParameterFloat* st = dynamic_cast<AudioParameterFloat*>(apvts.getParameter("smoothTime"));
-    if (st)
-    {
-        upperLimit = st->range.end;
-        // upperLimit now contains the value 500, or whatever the maximum of your NormalisableRange is.
-    }
+    float defaultSmoothTime = *apvts.getRawParameterValue(smoothTime);
+    leak = defaultSmoothTime < .1 ? 0.0 : static_cast<float> (std::exp (-(fftSize) / (defaultSmoothTime * 0.001 * fs)));
+
+    averager.setMode (static_cast<SpectrumAverager::Mode> ((int) *apvts.getRawParameterValue(avgMode)));
+    averager.setNumFrames ((int) *apvts.getRawParameterValue(avgFrames));
+    peakDetector.setNumPeaks ((int) *apvts.getRawParameterValue(numPeaks));
+
+    transferFunction.prepare (fs);
+    stereoCorrelation.prepare (fs);
+    levelMeter.prepare (fs);
+    percentiles.prepare (fs);
+    percentiles.setWindowSeconds (getPercentileWindowSeconds ((int) apvts.getRawParameterValue (percentileWindow)->load()));
+    spectrogram.prepare (fs);
+
+    // The FIFO doesn't overlap frames, so they come every fftSize samples
+    peakHold.prepare (fs, fftSize);
+    peakHold.setHoldSeconds (*apvts.getRawParameterValue (peakHoldTime));
+    peakHold.setFallRate (*apvts.getRawParameterValue (peakFallRate));
+    peakHold.setInfinite (apvts.getRawParameterValue (infinitePeakHold)->load() > 0.5f);
+
+    noiseFloor.prepare (fs, fftSize);
+    noiseFloor.setWindowSeconds (getNoiseFloorWindowSeconds ((int) apvts.getRawParameterValue (noiseFloorWindow)->load()));
+
+    if (getDisplayMode() == DisplayMode::rtaOctave)
+        bandAnalyzer.setResolution (BandAnalyzer::Resolution::octave);
     else
+        bandAnalyzer.setResolution (BandAnalyzer::Resolution::thirdOctave);
+
+    bandAnalyzer.setUseFilterbank (apvts.getRawParameterValue (rtaFilterbank)->load() > 0.5f);
+    bandAnalyzer.prepare (fs);
+    onsetDetector.prepare();
+    harmonicAnalyzer.prepare (fs);
+    toneTracker.prepare (fs);
+
+    weighting.setCurve (static_cast<SpectrumWeighting::Curve> ((int) *apvts.getRawParameterValue(weightingCurve)));
+    weighting.setTilt (*apvts.getRawParameterValue(tilt));
+    bandAnalyzer.setWeighting (static_cast<SpectrumWeighting::Curve> ((int) *apvts.getRawParameterValue(weightingCurve)),
+                               *apvts.getRawParameterValue(tilt));
+    weighting.prepare (fs);
+    samplePosition = 0;
+    frameEnd = 0;
+
+    // Frame times count from here, so older frames would sort wrongly
+    history.clear();
+    nextHistoryFrame = 0;
+
+    // Pick the pipeline instantiation for this layout
+    auto numChannels = juce::jlimit (1, AnalysisPipeline::maxChannels, getMainBusNumInputChannels());
+    pipeline = pipelines[(size_t) numChannels - 1].get();
+    jassert (pipeline != nullptr && pipeline->getFFTOrder() == fftOrder);
+
+    sharedExport.setFormat (fs, getMainBusNumInputChannels() > 1 ? SharedSpectrum::stereo : SharedSpectrum::mono);
+
+    // Unprepared, both take no memory or threads and ignore what's pushed
+    if (not analysisOnly)
     {
-        upperLimit = 0.95;
+        multichannel.prepare (fs, getMainBusNumInputChannels());
+
+        // The analysed channels, as they come in
+        recorder.prepare (fs, numChannels, samplesPerBlock);
     }
-    maxLeak = static_cast<float> (std::exp (-(fftSize) / (upperLimit * 0.001 * fs)));
 
-    float defaultSmoothTime = *apvts.getRawParameterValue(smoothTime);
-    leak = defaultSmoothTime < .1 ? 0.0 : static_cast<float> (std::exp (-(fftSize) / (defaultSmoothTime * 0.001 * fs)));
+    recorder.setSeconds (*apvts.getRawParameterValue (captureSeconds));
+    recorder.setTrigger (static_cast<CaptureRecorder::Trigger> ((int) *apvts.getRawParameterValue (captureTrigger)));
+    recorder.setThresholdDb (*apvts.getRawParameterValue (captureThreshold));
 
     preparedToPlay = true;
+    updateChannelLanes();
 }
 
 void PluginProcessor::releaseResources()
@@ -142,6 +364,8 @@ void PluginProcessor::releaseResources()
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
     preparedToPlay = false;
+    multichannel.release();
+    recorder.release();
 }
 
 bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
@@ -165,14 +389,28 @@ bool PluginProcessor::isBusesLayoutSupported (const BusesLayout& layouts) const
 //    return true;
 //  #endif
 
-    // For analyzer Check if the layout has mono or stereo input and no output
-    if (layouts.getMainInputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainInputChannelSet() != juce::AudioChannelSet::stereo())
+    // For analyzer Check if the layout has an input and no output. Mono and
+    // stereo, plus surround and ambisonic layouts (5.1, 7.1.4, third order)
+    // up to what the multichannel analysis takes.
+    auto mainInput = layouts.getMainInputChannelSet();
+
+    if (mainInput.isDisabled() || mainInput.size() > MultichannelAnalyzer::maxChannels)
         return false;
 
     if (not layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
+    // The sidechain reference is optional, but if it's there it has to be mono or stereo too
+    if (layouts.inputBuses.size() > 1)
+    {
+        auto sidechain = layouts.getChannelSet (true, 1);
+
+        if (not sidechain.isDisabled()
+         && sidechain != juce::AudioChannelSet::mono()
+         && sidechain != juce::AudioChannelSet::stereo())
+            return false;
+    }
+
     return true;
 
 }
@@ -205,47 +443,223 @@ void PluginProcessor::processBlock (juce::AudioBuffer<float>& buffer,
     // Alternatively, you can process the samples with the channels
     // interleaved by keeping the same state.
 
-    // Get left channel
-    auto *channelData = buffer.getReadPointer(0);
+    // Left channel of the sidechain is the reference for the transfer function, when connected
+    const float* sidechainData = nullptr;
+
+    if (getBusCount (true) > 1)
+    {
+        auto sidechainBuffer = getBusBuffer (buffer, true, 1);
+
+        if (sidechainBuffer.getNumChannels() > 0)
+            sidechainData = sidechainBuffer.getReadPointer (0);
+    }
+
+    sidechainActive = sidechainData != nullptr;
+
+    auto mainBuffer = getBusBuffer (buffer, true, 0);
+
+    if (mainBuffer.getNumChannels() == 0)
+        return;
+
+    // Normally picked in prepareToPlay, this only kicks in if the host hands us
+    // a different channel count than it promised
+    auto numChannels = juce::jmin (mainBuffer.getNumChannels(), AnalysisPipeline::maxChannels);
+
+    if (pipeline->getNumChannels() != numChannels)
+        pipeline = pipelines[(size_t) numChannels - 1].get();
+
+    // The right channel goes to the phase and correlation analysis
+    stereoActive = numChannels > 1;
+
+    // Meters read the whole block in one go, before the FIFO loop below
+    levelMeter.process (mainBuffer, mainBuffer.getNumChannels());
+
+    // Every sample goes into the capture ring
+    recorder.push (mainBuffer.getArrayOfReadPointers(), numChannels, mainBuffer.getNumSamples());
 
-    // Accumulate in FIFO buffer
-    for (auto i = 0; i < buffer.getNumSamples(); i++)
+    // Every channel for the lanes, the workers do the rest. The main pipeline
+    // carries on alongside, it's what paces the display.
+    if (getDisplayMode() == DisplayMode::channels && mainBuffer.getNumChannels() >= multichannel.getNumChannels())
     {
-        // Push next sample into FIFO
-        if (fifoIndex < fftSize)
-            fifo[fifoIndex++] = channelData[i];
-
-        if (fifoIndex == fftSize)
-        {
-            if (not nextFFTBlockReady.get())
-            {
-                // Zero temp FFT buffer
-                juce::zeromem (fftData, sizeof (fftData));
-                // Copy audio buffer into fftData for processing
-                memcpy (fftData, fifo, sizeof (fifo));
-                // Reset FIFO buffer index
-                fifoIndex = 0;
-                // Apply windowing function and do FFT
-                window.multiplyWithWindowingTable (fftData, fftSize);
-                forwardFFT.performFrequencyOnlyForwardTransform (fftData);
-
-                // Smooth FFT data for visualization
-                for (int n = 0; n < fftSize / 2; n++)
-                {
-                    smoothedFftData[n]    = leak    * smoothedFftData[n]    + (1 - leak)    * fftData[n];
-                    maxSmoothedFftData[n] = maxLeak * maxSmoothedFftData[n] + (1 - maxLeak) * fftData[n];
-                }
-
-                //            for (int n = 0; n < fftSize; n++)
-                //            {
-                //                std::cout << smoothedFftData[n] << ", ";
-                //            }
-                //            std::cout << "\n";
-
-                nextFFTBlockReady = true;
-            }
-        }
+        multichannel.setLeak (leak);
+        multichannel.push (mainBuffer.getArrayOfReadPointers(), mainBuffer.getNumSamples());
     }
+
+    auto* channelData = mainBuffer.getReadPointer (0);
+    auto numSamples = buffer.getNumSamples();
+    // The filterbank runs on every sample rather than on frames
+    if (isRtaMode (getDisplayMode()))
+        bandAnalyzer.processSamples (channelData, numSamples);
+    auto i = 0;
+
+    // The tracker stands in for the FFT in its mode, so the FIFO is left alone
+    auto trackerMode = getDisplayMode() == DisplayMode::tracker;
+
+    if (trackerMode)
+        toneTracker.process (channelData, numSamples);
+
+    while (not trackerMode)
+    {
+        // Every frame is analysed, whether or not the editor has taken the last one
+        if (pipeline->isFull())
+            processFrame (sidechainData != nullptr);
+
+        if (i == numSamples)
+            break;
+
+        const PerformanceCounters::ScopedTimer timer (performance, PerformanceCounters::Stage::fifoIngest);
+        auto fifoStart = pipeline->getNumBuffered();
+        auto numTaken = pipeline->push (mainBuffer.getArrayOfReadPointers(), i, numSamples - i);
+
+        if (sidechainData != nullptr)
+            for (int j = 0; j < numTaken; ++j)
+                referenceFifo[fifoStart + j] = transferFunction.pushSample (sidechainData[i + j], channelData[i + j]);
+
+        i += numTaken;
+        frameEnd = samplePosition + i;
+    }
+
+    // The delay line has to run on every sample, even in tracker mode where the FIFO is left alone
+    if (sidechainData != nullptr)
+        for (; i < numSamples; ++i)
+            transferFunction.pushSample (sidechainData[i], channelData[i]);
+
+    samplePosition += numSamples;
+}
+
+void PluginProcessor::processFrame (bool sidechainConnected)
+{
+    using Stage = PerformanceCounters::Stage;
+
+    // The averages, the peak hold, the onsets, the percentiles, the noise floor,
+    // the bands, the export and the history carry on with every frame, editor
+    // or not. What only the display reads is skipped while the editor still has
+    // the last frame, and this one isn't handed over.
+    auto display = not nextFFTBlockReady.get();
+
+    // Harmonics are measured through a low-leakage window, everything else uses Hann
+    auto harmonicMode = getDisplayMode() == DisplayMode::harmonics;
+    auto spectrogramMode = getDisplayMode() == DisplayMode::spectrogram;
+    auto window = AnalysisPipeline::Window::hann;
+
+    if (harmonicMode)
+    {
+        window = apvts.getRawParameterValue (flatTopWindow)->load() > 0.5f ? AnalysisPipeline::Window::flatTop
+                                                                           : AnalysisPipeline::Window::blackmanHarris;
+        harmonicAnalyzer.setWindow (window);
+    }
+
+    pipeline->setWindow (window);
+
+    {
+        const PerformanceCounters::ScopedTimer timer (performance, Stage::windowing);
+        pipeline->applyWindow();
+    }
+
+    {
+        const PerformanceCounters::ScopedTimer timer (performance, Stage::fft);
+        pipeline->performFFT();
+
+        // The reassignment's extra transforms are of the same samples, so they go in with it
+        if (spectrogramMode && display)
+            spectrogram.transform (pipeline->getFifo (0));
+    }
+
+    // The sidechain and stereo analyses share the complex left spectrum,
+    // so they have to run before it's turned into magnitudes. They window
+    // their other input with Hann, so they sit out the harmonics windows
+    // rather than cross two different ones.
+    auto* spectrum = pipeline->getSpectrum();
+    auto crossSpectra = display && window == AnalysisPipeline::Window::hann;
+
+    if (sidechainConnected && crossSpectra)
+        transferFunction.processFrame (referenceFifo, spectrum);
+
+    if (pipeline->getNumChannels() > 1 && crossSpectra)
+        stereoCorrelation.processFrame (spectrum, pipeline->getFifo (1));
+
+    const float* magnitudes;
+
+    {
+        const PerformanceCounters::ScopedTimer timer (performance, Stage::smoothing);
+        // Weighting and tilt go in with the magnitudes, except when measuring distortion
+        auto* gains = weighting.update();
+        magnitudes = pipeline->computeMagnitudes (harmonicMode ? nullptr : gains);
+        peakHold.process (magnitudes);
+
+        // Smooth FFT data for visualization
+        averager.process (magnitudes, averagedFftData, leak);
+
+        // Flux needs the raw frame, while it's still in cache
+        onsetDetector.processFrame (magnitudes, pipeline->getFifo (0), frameEnd, frameOnsets);
+    }
+
+    // The onset trigger has to fire with the editor closed too
+    if (frameOnsets.isOnset)
+        recorder.onsetAt (frameOnsets.onsetSample);
+
+    // Statistics of what the spectrum shows, so not through the harmonics windows
+    if (arePercentilesShown() && not harmonicMode)
+        percentiles.processFrame (magnitudes, percentileResult);
+
+    if (isNoiseFloorShown() && not harmonicMode)
+        noiseFloor.processFrame (magnitudes);
+
+    // Bands are integrated from the raw magnitudes, with their own smoothing on
+    // power. Their hold and fall count frames, so every frame goes in.
+    if (isRtaMode (getDisplayMode()))
+        bandAnalyzer.processFrame (magnitudes, leak, bandResult);
+
+    // Straight into the shared ring, when the export is on
+    sharedExport.publish (averagedFftData, 1.0f / fftSize);
+
+    // Into the history in the display's dB, unless a paused display is looking through it
+    if (frameEnd >= nextHistoryFrame && not historyFrozen.load())
+    {
+        auto referenceDb = juce::Decibels::gainToDecibels ((float) fftSize);
+
+        for (int n = 0; n < fftSize / 2; ++n)
+            historyDb[n] = juce::Decibels::gainToDecibels (averagedFftData[n]) - referenceDb;
+
+        history.push (historyDb, (double) frameEnd * 1000.0 / fs);
+        nextHistoryFrame = frameEnd + (juce::int64) (fs / historyFramesPerSecond);
+    }
+
+    if (not display)
+    {
+        performance.countDroppedFrame();
+        return;
+    }
+
+    const PerformanceCounters::ScopedTimer timer (performance, Stage::framePublish);
+
+    onsets = frameOnsets;
+
+    std::copy (averagedFftData, averagedFftData + fftSize / 2, smoothedFftData);
+    std::copy (peakHold.getLevels(), peakHold.getLevels() + fftSize / 2, heldFftData);
+
+    if (isNoiseFloorShown())
+        std::copy (noiseFloor.getLevels(), noiseFloor.getLevels() + fftSize / 2, noiseFloorData);
+
+    if (arePercentilesShown())
+        percentileLevels = percentileResult;
+
+    // Find peaks once per frame here rather than on every repaint
+    peakDetector.process (smoothedFftData, fftSize / 2, fftSize, fs,
+                          juce::Decibels::gainToDecibels ((float) fftSize), spectralPeaks);
+
+    levelMeter.getReadings (levelReadings);
+
+    if (isRtaMode (getDisplayMode()))
+        bandLevels = bandResult;
+
+    if (harmonicMode)
+        harmonicAnalyzer.processFrame (magnitudes, harmonicReadings);
+
+    if (spectrogramMode)
+        spectrogram.reassign (spectrum, spectrogramSlices);
+
+    nextFFTBlockReady = true;
 }
 
 //==============================================================================
@@ -265,17 +679,41 @@ juce::AudioProcessorEditor* PluginProcessor::createEditor()
 //==============================================================================
 void PluginProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
-    juce::ignoreUnused (destData);
+    // Parameters plus the reference spectra. Written as a binary ValueTree rather
+    // than XML, which would turn the levels into base64 text.
+    auto state = apvts.copyState();
+    state.appendChild (references.toValueTree(), nullptr);
+
+    juce::MemoryOutputStream stream (destData, false);
+    state.writeToStream (stream);
 }
 
 void PluginProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
-    juce::ignoreUnused (data, sizeInBytes);
+    auto state = juce::ValueTree::readFromData (data, (size_t) sizeInBytes);
+
+    if (not state.hasType (apvts.state.getType()))
+        return;
+
+    auto referenceTree = state.getChildWithName (ReferenceSnapshots::treeType);
+
+    if (referenceTree.isValid())
+    {
+        references.fromValueTree (referenceTree);
+        state.removeChild (referenceTree, nullptr);
+    }
+
+    apvts.replaceState (state);
+
+    if (state.hasProperty (trackerTargets))
+    {
+        juce::Array<float> frequencies;
+
+        for (const auto& token : juce::StringArray::fromTokens (state[trackerTargets].toString(), false))
+            frequencies.add (token.getFloatValue());
+
+        toneTracker.setTargets (frequencies);
+    }
 }
 
 void PluginProcessor::parameterChanged (const juce::String& parameterID, float newValue)
@@ -284,6 +722,176 @@ void PluginProcessor::parameterChanged (const juce::String& parameterID, float n
         leak = newValue < .1 ? 0.0 : static_cast<float> (std::exp (-(fftSize) / (newValue * 0.001 * fs)));
         jassert(leak <= 1 && leak >= 0);
     }
+    else if (parameterID == avgMode) {
+        averager.setMode (static_cast<SpectrumAverager::Mode> ((int) newValue));
+    }
+    else if (parameterID == avgFrames) {
+        averager.setNumFrames ((int) newValue);
+    }
+    else if (parameterID == numPeaks) {
+        peakDetector.setNumPeaks ((int) newValue);
+    }
+    else if (parameterID == displayMode) {
+        if (static_cast<DisplayMode> ((int) newValue) == DisplayMode::rtaOctave)
+            bandAnalyzer.setResolution (BandAnalyzer::Resolution::octave);
+        else
+            bandAnalyzer.setResolution (BandAnalyzer::Resolution::thirdOctave);
+
+        // The channel lanes' workers start and stop on the message thread
+        triggerAsyncUpdate();
+    }
+    else if (parameterID == rtaFilterbank) {
+        bandAnalyzer.setUseFilterbank (newValue > 0.5f);
+    }
+    else if (parameterID == weightingCurve) {
+        weighting.setCurve (static_cast<SpectrumWeighting::Curve> ((int) newValue));
+        bandAnalyzer.setWeighting (static_cast<SpectrumWeighting::Curve> ((int) newValue), *apvts.getRawParameterValue (tilt));
+
+        // Averages of differently weighted frames mean nothing
+        averager.reset();
+    }
+    else if (parameterID == tilt) {
+        weighting.setTilt (newValue);
+        bandAnalyzer.setWeighting (static_cast<SpectrumWeighting::Curve> ((int) *apvts.getRawParameterValue (weightingCurve)), newValue);
+        averager.reset();
+    }
+    else if (parameterID == percentileWindow) {
+        percentiles.setWindowSeconds (getPercentileWindowSeconds ((int) newValue));
+        percentiles.reset();
+    }
+    else if (parameterID == peakHoldTime) {
+        peakHold.setHoldSeconds (newValue);
+    }
+    else if (parameterID == peakFallRate) {
+        peakHold.setFallRate (newValue);
+    }
+    else if (parameterID == infinitePeakHold) {
+        peakHold.setInfinite (newValue > 0.5f);
+    }
+    else if (parameterID == captureSeconds) {
+        recorder.setSeconds (newValue);
+    }
+    else if (parameterID == captureTrigger) {
+        recorder.setTrigger (static_cast<CaptureRecorder::Trigger> ((int) newValue));
+    }
+    else if (parameterID == captureThreshold) {
+        recorder.setThresholdDb (newValue);
+    }
+    else if (parameterID == noiseFloorWindow) {
+        noiseFloor.setWindowSeconds (getNoiseFloorWindowSeconds ((int) newValue));
+        noiseFloor.reset();
+    }
+    else if (parameterID == shmExport) {
+        // Creating the segment allocates and can block, so never on the audio thread
+        triggerAsyncUpdate();
+    }
+}
+
+void PluginProcessor::handleAsyncUpdate()
+{
+    if (apvts.getRawParameterValue (shmExport)->load() > 0.5f)
+        sharedExport.open();
+    else
+        sharedExport.close();
+
+    updateChannelLanes();
+}
+
+void PluginProcessor::updateChannelLanes()
+{
+    // An analysis-only processor never prepares the lanes, so they stay idle
+    multichannel.setActive (preparedToPlay && getDisplayMode() == DisplayMode::channels);
+}
+
+void PluginProcessor::updateTrackProperties (const TrackProperties& properties)
+{
+    if (properties.name.isNotEmpty())
+        sharedExport.setName (properties.name);
+}
+
+void PluginProcessor::resetAveraging()
+{
+    averager.reset();
+    percentiles.reset();
+    peakHold.reset();
+    noiseFloor.reset();
+}
+
+void PluginProcessor::setParameterValue (const juce::String& parameterID, float value)
+{
+    if (auto* parameter = apvts.getParameter (parameterID))
+        parameter->setValueNotifyingHost (parameter->convertTo0to1 (value));
+    else
+        jassertfalse; // No such parameter
+}
+
+PluginProcessor::DisplayMode PluginProcessor::getDisplayMode() const
+{
+    return static_cast<DisplayMode> ((int) apvts.getRawParameterValue (displayMode)->load());
+}
+
+bool PluginProcessor::isPhaseLaneVisible() const
+{
+    // Not updated through the harmonics windows
+    return apvts.getRawParameterValue (phaseLane)->load() > 0.5f && getDisplayMode() != DisplayMode::harmonics;
+}
+
+juce::String PluginProcessor::getAnalysedChannelsLabel() const
+{
+    auto numInputs = getMainBusNumInputChannels();
+
+    if (numInputs <= AnalysisPipeline::maxChannels)
+        return {};
+
+    return "Ch 1-" + juce::String (AnalysisPipeline::maxChannels) + " of " + juce::String (numInputs);
+}
+
+bool PluginProcessor::arePercentilesShown() const
+{
+    return apvts.getRawParameterValue (percentileWindow)->load() > 0.5f;
+}
+
+bool PluginProcessor::isNoiseFloorShown() const
+{
+    return apvts.getRawParameterValue (noiseFloorWindow)->load() > 0.5f;
+}
+
+bool PluginProcessor::isSnrShadingOn() const
+{
+    return apvts.getRawParameterValue (snrShading)->load() > 0.5f;
+}
+
+void PluginProcessor::setTrackerTargets (const juce::Array<float>& frequencies)
+{
+    toneTracker.setTargets (frequencies);
+
+    juce::StringArray tokens;
+
+    for (auto frequency : toneTracker.getTargets())
+        tokens.add (juce::String (frequency));
+
+    apvts.state.setProperty (trackerTargets, tokens.joinIntoString (" "), nullptr);
+}
+
+juce::StringArray PluginProcessor::getInputChannelNames() const
+{
+    juce::StringArray names;
+
+    if (auto* bus = getBus (true, 0))
+        for (auto type : bus->getCurrentLayout().getChannelTypes())
+            names.add (juce::AudioChannelSet::getAbbreviatedChannelTypeName (type));
+
+    return names;
+}
+
+void PluginProcessor::findSidechainDelay()
+{
+    transferFunction.requestDelaySearch();
+}
+
+void PluginProcessor::updateSidechainDelay()
+{
+    transferFunction.updateDelaySearch();
 }
 
 //==============================================================================
@@ -2,16 +2,47 @@
 
 #include <JuceHeader.h>
 #include "Analyzer.h"
+#include "SpectrumAverager.h"
+#include "PeakDetector.h"
+#include "TransferFunction.h"
+#include "StereoCorrelation.h"
+#include "LevelMeter.h"
+#include "SharedSpectrumExport.h"
+#include "AnalysisPipeline.h"
+#include "PerformanceCounters.h"
+#include "ReferenceSnapshots.h"
+#include "BandAnalyzer.h"
+#include "OnsetDetector.h"
+#include "HarmonicAnalyzer.h"
+#include "ToneTracker.h"
+#include "SpectrumWeighting.h"
+#include "MultichannelAnalyzer.h"
+#include "SpectrumPercentiles.h"
+#include "ReassignedSpectrogram.h"
+#include "PeakHold.h"
+#include "CaptureRecorder.h"
+#include "NoiseFloorTracker.h"
+#include "SpectralHistory.h"
 
 #if (MSVC)
 #include "ipps.h"
 #endif
 
 class PluginProcessor : public juce::AudioProcessor,
-                        private juce::AudioProcessorValueTreeState::Listener  // Listener for parameters
+                        private juce::AudioProcessorValueTreeState::Listener, // Listener for parameters
+                        private juce::AsyncUpdater
 {
 public:
-    PluginProcessor();
+    // The plugin gets everything. Offline analysis, like the renderer's, only
+    // needs the spectrum: no capture ring or writer thread and no multichannel
+    // workers.
+    enum class Use
+    {
+        plugin = 0,
+        analysisOnly
+    };
+
+    explicit PluginProcessor (Use use = Use::plugin);
     ~PluginProcessor() override;
 
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
@@ -42,34 +73,164 @@ public:
 
     void parameterChanged (const juce::String& parameterID, float newValue) override;
 
+    void updateTrackProperties (const TrackProperties& properties) override;
+
+    // Restarts the linear and infinite averages, the percentile statistics, the
+    // peak hold and the noise floor, safe to call from the message thread
+    void resetAveraging();
+
+    // Sets a parameter by ID in its own units, as if the host had. For tests and
+    // offline use, before prepareToPlay, which reads the parameters back.
+    void setParameterValue (const juce::String& parameterID, float value);
+
+    enum class DisplayMode
+    {
+        spectrum = 0,
+        transferFunction,
+        rtaThirdOctave,
+        rtaOctave,
+        harmonics,
+        tracker,
+        channels,
+        spectrogram
+    };
+
+    DisplayMode getDisplayMode() const;
+
+    static bool isRtaMode (DisplayMode mode) { return mode == DisplayMode::rtaThirdOctave || mode == DisplayMode::rtaOctave; }
+
+    // Sidechain measurement. The delay search is started and finished from the message thread.
+    const TransferFunction& getTransferFunction() const { return transferFunction; }
+    void findSidechainDelay();
+    void updateSidechainDelay();
+
+    // Left/right phase and correlation, only updated for stereo inputs and not in harmonics mode
+    const StereoCorrelation& getStereoCorrelation() const { return stereoCorrelation; }
+    bool isPhaseLaneVisible() const;
+
+    // L10, L50 and L90 per bin over the chosen window, gathered while they're shown
+    bool arePercentilesShown() const;
+
+    // Noise floor per bin by minimum statistics, tracked while it's shown
+    bool isNoiseFloorShown() const;
+    bool isSnrShadingOn() const;
+
+    // The last half minute of input, for saving what the display just showed
+    CaptureRecorder& getCaptureRecorder() { return recorder; }
+
+    // Only the channel lanes take a surround or ambisonic input whole. The
+    // meters, loudness, capture and the other displays use the first two
+    // channels, and label themselves with this. Empty up to stereo.
+    juce::String getAnalysedChannelsLabel() const;
+
+    // Stage timings, the editor's drawing records into these too
+    PerformanceCounters& getPerformanceCounters() { return performance; }
+
+    // Frozen spectra to compare against, saved with the state. Message thread.
+    ReferenceSnapshots& getReferences() { return references; }
+
+    // The last five minutes of the spectrum, recorded whether or not the editor
+    // is open. Freezing stops the recording so a paused display can scrub
+    // through it without the frames moving. Message thread.
+    const SpectralHistory& getHistory() const { return history; }
+    void setHistoryFrozen (bool shouldBeFrozen) { historyFrozen = shouldBeFrozen; }
+
+    // Levels of a few chosen frequencies, run instead of the FFT in tracker mode.
+    // Setting the targets also stores them in the state. Message thread.
+    const ToneTracker& getToneTracker() const { return toneTracker; }
+    void setTrackerTargets (const juce::Array<float>& frequencies);
+
+    // Every input channel's spectrum for the lanes display, worked out off the audio thread
+    MultichannelAnalyzer& getMultichannelAnalyzer() { return multichannel; }
+    juce::StringArray getInputChannelNames() const;
+
+    // Index of this instance's shared-memory segment, or -1 while the export is off
+    int getSharedExportIndex() const { return sharedExport.getInstanceIndex(); }
+
     enum
     {
         fftOrder  = 11,
         fftSize   = 1 << fftOrder, // 2048
-        scopeSize = fftSize >> 1   // 1024
+        scopeSize = fftSize >> 1,  // 1024
+        maxAverageFrames = 64
     };
 
     juce::Atomic<bool> nextFFTBlockReady = false;
     float smoothedFftData [2 * fftSize];
-    float maxSmoothedFftData [2 * fftSize];
+    float heldFftData [fftSize / 2]; // Peak hold per bin for the outline, on the scale of smoothedFftData, published with each frame
+    float noiseFloorData [fftSize / 2]; // Noise floor per bin on the same scale, published with each frame while shown
+    PeakDetector::Result spectralPeaks; // Strongest peaks of smoothedFftData, published with each frame
+    std::atomic<bool> sidechainActive { false };
+    std::atomic<bool> stereoActive { false };
+    LevelMeter::Readings levelReadings; // Peak, RMS and loudness, published with each frame
+    BandAnalyzer::Result bandLevels; // Octave or third-octave levels, published with each frame in the RTA modes
+    OnsetDetector::Result onsets; // Spectral flux and any onset in the frame, published with each frame
+    HarmonicAnalyzer::Result harmonicReadings; // Fundamental, harmonics and distortion, published with each frame in harmonics mode
+    SpectrumPercentiles::Result percentileLevels; // Statistical levels per bin, refreshed a few times a second while shown
+    ReassignedSpectrogram::Result spectrogramSlices; // The frame's energy moved to where it belongs, published with each frame in spectrogram mode
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PluginProcessor)
 
+    // Opens or closes the shared-memory export, and starts or stops the
+    // channel lanes, on the message thread
+    void handleAsyncUpdate() override;
+    void updateChannelLanes();
+
     bool preparedToPlay = false;
+    const bool analysisOnly; // Set at construction, see Use
 
     // Parameters
     float leak;
-    float maxLeak;
     double fs;
 
     // APVTS and Undo Manager
     juce::AudioProcessorValueTreeState apvts;
     juce::UndoManager undoManager;
 
-    // FFT Setup
-    juce::dsp::FFT forwardFFT;
-    juce::dsp::WindowingFunction<float> window;
-    float fifo [fftSize];
-    float fftData [2 * fftSize]; // dsp::FFT requires the size of the array passed in to be 2 * getSize().
-    int fifoIndex = 0;
+    // FIFO, window, FFT and magnitudes, one instantiation per channel count
+    std::array<std::unique_ptr<AnalysisPipeline>, AnalysisPipeline::maxChannels> pipelines;
+    AnalysisPipeline* pipeline = nullptr;
+    float referenceFifo [fftSize]; // Delay-compensated sidechain, filled alongside the pipeline's FIFO
+    float averagedFftData [fftSize / 2]; // The average itself, copied to smoothedFftData when the editor takes a frame
+    SpectrumPercentiles::Result percentileResult; // Gathered with every frame, copied to percentileLevels likewise
+    OnsetDetector::Result frameOnsets; // Found in every frame, copied to onsets likewise
+    BandAnalyzer::Result bandResult; // Every frame in the RTA modes, copied to bandLevels likewise
+
+    void processFrame (bool sidechainConnected);
+
+    // Input samples seen since prepareToPlay, and the position just after
+    // the last one in the FIFO. For onset timestamps.
+    juce::int64 samplePosition = 0;
+    juce::int64 frameEnd = 0;
+
+    // Averaging of successive FFT frames into smoothedFftData
+    SpectrumAverager averager;
+    PeakDetector peakDetector;
+    TransferFunction transferFunction;
+    StereoCorrelation stereoCorrelation;
+    LevelMeter levelMeter;
+    SharedSpectrumExport sharedExport;
+    PerformanceCounters performance;
+    ReferenceSnapshots references;
+
+    // At most historyFramesPerSecond, so the ring covers the same time at any
+    // sample rate. Empty for analysis-only use.
+    static constexpr double historySeconds = 300.0;
+    static constexpr double historyFramesPerSecond = 30.0;
+    SpectralHistory history;
+    std::atomic<bool> historyFrozen { false };
+    juce::int64 nextHistoryFrame = 0;
+    float historyDb [fftSize / 2];
+
+    BandAnalyzer bandAnalyzer;
+    OnsetDetector onsetDetector;
+    HarmonicAnalyzer harmonicAnalyzer;
+    ToneTracker toneTracker;
+    SpectrumWeighting weighting;
+    MultichannelAnalyzer multichannel;
+    SpectrumPercentiles percentiles;
+    ReassignedSpectrogram spectrogram;
+    PeakHold peakHold;
+    NoiseFloorTracker noiseFloor;
+    CaptureRecorder recorder;
 };
@@ -0,0 +1,110 @@
+/*
+==============================================================================
+
+    ReassignedSpectrogram.cpp
+    Created: 19 Oct 2026 4:43:40am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "ReassignedSpectrogram.h"
+
+//==============================================================================
+ReassignedSpectrogram::ReassignedSpectrogram (int fftOrder)
+    : fftSize (1 << fftOrder),
+      fft (fftOrder)
+{
+    using WindowingFunction = juce::dsp::WindowingFunction<float>;
+
+    // The same normalised table the pipeline windows with, so the two can be
+    // built from it with the same scaling
+    std::vector<float> window ((size_t) fftSize);
+    WindowingFunction::fillWindowingTables (window.data(), (size_t) fftSize, WindowingFunction::hann, true);
+
+    derivativeWindow.resize ((size_t) fftSize);
+    timeWindow.resize ((size_t) fftSize);
+
+    // Hann is 0.5 - 0.5 cos (w n), whose derivative is 0.5 w sin (w n)
+    auto w = juce::MathConstants<double>::twoPi / (fftSize - 1);
+    auto scale = (double) window[(size_t) fftSize / 2] / (0.5 - 0.5 * std::cos (w * (fftSize / 2)));
+    auto centre = 0.5 * (fftSize - 1);
+    auto sumOfSquares = 0.0;
+
+    for (int n = 0; n < fftSize; ++n)
+    {
+        derivativeWindow[(size_t) n] = (float) (scale * 0.5 * w * std::sin (w * n));
+        timeWindow[(size_t) n] = (float) ((n - centre) * window[(size_t) n]);
+        sumOfSquares += (double) window[(size_t) n] * window[(size_t) n];
+    }
+
+    // A sine of amplitude A puts (A / 2)^2 * N * sum (h^2) into its bins, and reads 20 log (A / 2) on the display
+    powerScale = (float) (1.0 / (fftSize * sumOfSquares));
+
+    input.resize ((size_t) fftSize);
+    output.resize ((size_t) fftSize);
+}
+
+void ReassignedSpectrogram::prepare (double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    cellsPerLogHz = (float) (numCells / std::log (0.5 * sampleRate / minFrequency));
+}
+
+void ReassignedSpectrogram::transform (const float* samples) noexcept
+{
+    for (int n = 0; n < fftSize; ++n)
+        input[(size_t) n] = { samples[n] * derivativeWindow[(size_t) n], samples[n] * timeWindow[(size_t) n] };
+
+    fft.perform (input.data(), output.data(), false);
+}
+
+void ReassignedSpectrogram::reassign (const float* spectrum, Result& result) noexcept
+{
+    auto& power = result.levelsDb;
+
+    for (auto& slice : power)
+        std::fill (slice.begin(), slice.end(), 0.0f);
+
+    auto size = (float) fftSize;
+    auto binsPerRadian = size / juce::MathConstants<float>::twoPi;
+    auto hzPerBin = (float) sampleRate / size;
+    auto nyquist = 0.5f * (float) sampleRate;
+    auto frameCentre = 0.5f * (size - 1.0f);
+    auto samplesPerSlice = size / (float) slicesPerFrame;
+
+    // Anything 120 dB below full scale isn't worth a log, and its offsets are mostly noise
+    auto minPower = size * size * 1.0e-12f;
+
+    for (int k = 1; k < fftSize / 2; ++k)
+    {
+        Complex hann (spectrum[2 * k], spectrum[2 * k + 1]);
+        auto binPower = std::norm (hann);
+
+        if (binPower < minPower)
+            continue;
+
+        // The spectrum of a real signal is conjugate symmetric, so the two real transforms separate out
+        auto z = output[(size_t) k];
+        auto mirrored = std::conj (output[(size_t) (fftSize - k)]);
+        auto derivative = 0.5f * (z + mirrored);
+        auto timed = Complex (0.0f, -0.5f) * (z - mirrored);
+
+        auto frequency = ((float) k - binsPerRadian * (derivative * std::conj (hann)).imag() / binPower) * hzPerBin;
+        auto time = (timed * std::conj (hann)).real() / binPower + frameCentre;
+
+        if (frequency < minFrequency || frequency >= nyquist)
+            continue;
+
+        auto cell = juce::jmin (numCells - 1, (int) (std::log (frequency / minFrequency) * cellsPerLogHz));
+        auto slice = juce::jlimit (0, slicesPerFrame - 1, (int) (time / samplesPerSlice));
+
+        power[(size_t) slice][(size_t) cell] += binPower;
+    }
+
+    for (auto& slice : power)
+        for (auto& level : slice)
+            level = level > 0.0f ? 10.0f * std::log10 (level * powerScale) : minDb;
+
+    result.numSlices = slicesPerFrame;
+}
@@ -0,0 +1,81 @@
+/*
+==============================================================================
+
+    ReassignedSpectrogram.h
+    Created: 19 Oct 2026 4:43:40am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Time-frequency reassignment of the Hann spectrum, for the spectrogram.
+
+    Each bin's energy is moved to where it actually comes from rather than
+    being drawn at the bin centre and the frame centre. The offsets come from
+    two more transforms of the same samples, through the window's derivative
+    (frequency) and through the window times time (time):
+
+        frequency = k - N / 2pi * Im (X_dh * conj (X_h)) / |X_h|^2   bins
+        time      = Re (X_th * conj (X_h)) / |X_h|^2                 samples from the frame centre
+
+    A tone between two bins ends up as one sharp line, and a click lands on
+    the right slice of the frame instead of being smeared across all of it,
+    which is a lot cheaper than getting there with a bigger FFT.
+
+    Both extra transforms are real, so they're done as one complex FFT of
+    x * dh + i * x * th and pulled apart afterwards. X_h is the pipeline's
+    own spectrum. The energy is summed into numCells log-spaced cells from
+    minFrequency to Nyquist, in slicesPerFrame slices across the frame.
+*/
+
+class ReassignedSpectrogram
+{
+public:
+    static constexpr int slicesPerFrame = 8;
+    static constexpr int numCells = 1024;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float minDb = -140.0f; // Cells nothing landed in
+
+    struct Result
+    {
+        int numSlices = 0; // 0 until the first frame
+        std::array<std::array<float, numCells>, slicesPerFrame> levelsDb {}; // Oldest slice first, on the display's scale
+    };
+
+    explicit ReassignedSpectrogram (int fftOrder);
+
+    void prepare (double sampleRate);
+
+    // Audio thread, once per frame. transform() takes the unwindowed samples
+    // the pipeline's spectrum came from, and belongs next to the pipeline's
+    // own FFT. reassign() then moves the energy of that Hann spectrum.
+    void transform (const float* samples) noexcept;
+    void reassign (const float* spectrum, Result& result) noexcept;
+
+private:
+    using Complex = juce::dsp::Complex<float>;
+
+    const int fftSize;
+    juce::dsp::FFT fft;
+
+    // The pipeline's normalised Hann differentiated, and multiplied by the time from its centre
+    std::vector<float> derivativeWindow;
+    std::vector<float> timeWindow;
+
+    std::vector<Complex> input;
+    std::vector<Complex> output;
+
+    double sampleRate = 44100.0;
+    float cellsPerLogHz = 1.0f;
+
+    // Turns the summed power of a tone's bins into its level on the display's scale
+    float powerScale = 1.0f;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReassignedSpectrogram)
+};
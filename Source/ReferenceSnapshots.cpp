@@ -0,0 +1,195 @@
+/*
+==============================================================================
+
+    ReferenceSnapshots.cpp
+    Created: 19 Oct 2026 4:17:00am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "ReferenceSnapshots.h"
+
+const juce::Identifier ReferenceSnapshots::treeType { "References" };
+
+static const juce::Identifier slotType   { "Reference" };
+static const juce::Identifier indexID    { "index" };
+static const juce::Identifier nameID     { "name" };
+static const juce::Identifier numBinsID  { "numBins" };
+static const juce::Identifier levelsID   { "levels" };
+
+// Hundredths of a dB, clamped to what an int16 holds
+static constexpr float unitsPerDb = 100.0f;
+static constexpr float minDb = -320.0f;
+static constexpr float maxDb = 320.0f;
+
+//==============================================================================
+ReferenceSnapshots::ReferenceSnapshots (int bins)
+    : numBins (bins)
+{
+    for (int s = 0; s < numSlots; ++s)
+        slots[(size_t) s].name = "Ref " + juce::String (s + 1);
+}
+
+void ReferenceSnapshots::store (int slot, const float* levelsDb, const juce::String& name)
+{
+    jassert (juce::isPositiveAndBelow (slot, numSlots));
+
+    {
+        const juce::ScopedLock sl (lock);
+        auto& s = slots[(size_t) slot];
+
+        s.levels.resize ((size_t) numBins);
+
+        for (int n = 0; n < numBins; ++n)
+            s.levels[(size_t) n] = (juce::int16) juce::roundToInt (juce::jlimit (minDb, maxDb, levelsDb[n]) * unitsPerDb);
+
+        if (name.isNotEmpty())
+            s.name = name;
+
+        ++s.version;
+    }
+
+    sendChangeMessage();
+}
+
+void ReferenceSnapshots::clear (int slot)
+{
+    jassert (juce::isPositiveAndBelow (slot, numSlots));
+
+    {
+        const juce::ScopedLock sl (lock);
+        auto& s = slots[(size_t) slot];
+        s.levels.clear();
+        s.levels.shrink_to_fit();
+        ++s.version;
+    }
+
+    sendChangeMessage();
+}
+
+void ReferenceSnapshots::setName (int slot, const juce::String& name)
+{
+    jassert (juce::isPositiveAndBelow (slot, numSlots));
+
+    {
+        const juce::ScopedLock sl (lock);
+        slots[(size_t) slot].name = name;
+    }
+
+    sendChangeMessage();
+}
+
+bool ReferenceSnapshots::isUsed (int slot) const
+{
+    const juce::ScopedLock sl (lock);
+    return not slots[(size_t) slot].levels.empty();
+}
+
+juce::String ReferenceSnapshots::getName (int slot) const
+{
+    const juce::ScopedLock sl (lock);
+    return slots[(size_t) slot].name;
+}
+
+int ReferenceSnapshots::getVersion (int slot) const
+{
+    const juce::ScopedLock sl (lock);
+    return slots[(size_t) slot].version;
+}
+
+bool ReferenceSnapshots::getLevels (int slot, std::vector<float>& levelsDb) const
+{
+    const juce::ScopedLock sl (lock);
+    const auto& s = slots[(size_t) slot];
+
+    if (s.levels.empty())
+        return false;
+
+    levelsDb.resize ((size_t) numBins);
+
+    for (size_t n = 0; n < s.levels.size(); ++n)
+        levelsDb[n] = (float) s.levels[n] / unitsPerDb;
+
+    return true;
+}
+
+//==============================================================================
+juce::ValueTree ReferenceSnapshots::toValueTree() const
+{
+    juce::ValueTree tree (treeType);
+    tree.setProperty (numBinsID, numBins, nullptr);
+
+    const juce::ScopedLock sl (lock);
+
+    for (int s = 0; s < numSlots; ++s)
+    {
+        const auto& slot = slots[(size_t) s];
+        juce::ValueTree child (slotType);
+        child.setProperty (indexID, s, nullptr);
+        child.setProperty (nameID, slot.name, nullptr);
+
+        // Stored little-endian whatever the machine, so a session moves between them
+        if (not slot.levels.empty())
+        {
+            juce::MemoryBlock block (slot.levels.size() * sizeof (juce::int16));
+            auto* bytes = static_cast<char*> (block.getData());
+
+            for (size_t n = 0; n < slot.levels.size(); ++n)
+            {
+                auto value = juce::ByteOrder::swapIfBigEndian ((juce::uint16) slot.levels[n]);
+                std::memcpy (bytes + 2 * n, &value, sizeof (value));
+            }
+
+            child.setProperty (levelsID, block, nullptr);
+        }
+
+        tree.appendChild (child, nullptr);
+    }
+
+    return tree;
+}
+
+void ReferenceSnapshots::fromValueTree (const juce::ValueTree& tree)
+{
+    {
+        const juce::ScopedLock sl (lock);
+
+        for (int s = 0; s < numSlots; ++s)
+        {
+            auto& slot = slots[(size_t) s];
+            slot.name = "Ref " + juce::String (s + 1);
+            slot.levels.clear();
+            ++slot.version;
+        }
+
+        // A session saved with another FFT size can't be shown, keep the names at least
+        auto sameSize = (int) tree.getProperty (numBinsID) == numBins;
+
+        for (const auto& child : tree)
+        {
+            if (not child.hasType (slotType))
+                continue;
+
+            auto s = (int) child.getProperty (indexID, -1);
+
+            if (not juce::isPositiveAndBelow (s, numSlots))
+                continue;
+
+            auto& slot = slots[(size_t) s];
+            slot.name = child.getProperty (nameID, slot.name).toString();
+
+            if (auto* block = child.getProperty (levelsID).getBinaryData();
+                block != nullptr && sameSize && block->getSize() == (size_t) numBins * sizeof (juce::int16))
+            {
+                auto* bytes = static_cast<const char*> (block->getData());
+                slot.levels.resize ((size_t) numBins);
+
+                for (size_t n = 0; n < slot.levels.size(); ++n)
+                    slot.levels[n] = (juce::int16) juce::ByteOrder::littleEndianShort (bytes + 2 * n);
+            }
+        }
+    }
+
+    sendChangeMessage();
+}
@@ -0,0 +1,65 @@
+/*
+==============================================================================
+
+    ReferenceSnapshots.h
+    Created: 19 Oct 2026 4:17:00am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    A few named spectra frozen for comparison, saved with the plugin state.
+
+    Levels are kept as 16-bit hundredths of a dB, so a slot is 2 bytes per bin
+    in memory and in the saved state. Everything is guarded by a lock, since
+    hosts may ask for the state from any thread. Listeners hear about every
+    change on the message thread.
+*/
+
+class ReferenceSnapshots  : public juce::ChangeBroadcaster
+{
+public:
+    static constexpr int numSlots = 4;
+
+    explicit ReferenceSnapshots (int numBins);
+
+    void store (int slot, const float* levelsDb, const juce::String& name);
+    void clear (int slot);
+    void setName (int slot, const juce::String& name);
+
+    bool isUsed (int slot) const;
+    juce::String getName (int slot) const;
+
+    // Goes up whenever the slot changes, so cached drawing can tell it's stale
+    int getVersion (int slot) const;
+
+    // Fills levelsDb with numBins values, returns false for an empty slot
+    bool getLevels (int slot, std::vector<float>& levelsDb) const;
+
+    int getNumBins() const { return numBins; }
+
+    juce::ValueTree toValueTree() const;
+    void fromValueTree (const juce::ValueTree& tree);
+
+    static const juce::Identifier treeType;
+
+private:
+    struct Slot
+    {
+        juce::String name;
+        std::vector<juce::int16> levels; // Empty when the slot isn't used
+        int version = 0;
+    };
+
+    const int numBins;
+    std::array<Slot, numSlots> slots;
+    juce::CriticalSection lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReferenceSnapshots)
+};
@@ -0,0 +1,210 @@
+/*
+==============================================================================
+
+    SharedSpectrumExport.cpp
+    Created: 19 Oct 2026 4:08:42am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "SharedSpectrumExport.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <cerrno>
+ #include <fcntl.h>
+ #include <signal.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+ #define SIMPLE_ANALYZER_SHARED_MEMORY 1
+#else
+ #define SIMPLE_ANALYZER_SHARED_MEMORY 0
+#endif
+
+//==============================================================================
+#if SIMPLE_ANALYZER_SHARED_MEMORY
+static juce::String getSegmentName (int index)
+{
+    return SharedSpectrum::namePrefix + juce::String (index);
+}
+
+// A segment left behind by a process that has since died (crashed, usually)
+static bool isStaleSegment (const juce::String& segmentName)
+{
+    auto fd = shm_open (segmentName.toRawUTF8(), O_RDONLY, 0);
+
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    auto stale = false;
+
+    if (fstat (fd, &info) == 0 && (size_t) info.st_size >= sizeof (SharedSpectrum::Header))
+    {
+        auto* mem = mmap (nullptr, sizeof (SharedSpectrum::Header), PROT_READ, MAP_SHARED, fd, 0);
+
+        if (mem != MAP_FAILED)
+        {
+            auto processId = static_cast<const SharedSpectrum::Header*> (mem)->processId;
+            stale = processId > 0 && kill ((pid_t) processId, 0) != 0 && errno == ESRCH;
+            munmap (mem, sizeof (SharedSpectrum::Header));
+        }
+    }
+
+    ::close (fd);
+    return stale;
+}
+#endif
+
+//==============================================================================
+SharedSpectrumExport::SharedSpectrumExport (int bins, int size)
+    : numBins (bins),
+      fftSize (size)
+{
+}
+
+SharedSpectrumExport::~SharedSpectrumExport()
+{
+    close();
+}
+
+bool SharedSpectrumExport::open()
+{
+   #if SIMPLE_ANALYZER_SHARED_MEMORY
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    if (header != nullptr)
+        return true;
+
+    auto headerSize = SharedSpectrum::getHeaderSize();
+    auto slotSize = SharedSpectrum::getSlotSize ((std::uint32_t) numBins);
+    auto size = (size_t) headerSize + (size_t) slotSize * (size_t) numSlots;
+
+    // Take the first free index, clearing out any left by dead processes on the way
+    for (int index = 0; index < SharedSpectrum::maxInstances; ++index)
+    {
+        auto segmentName = getSegmentName (index);
+        auto fd = shm_open (segmentName.toRawUTF8(), O_RDWR | O_CREAT | O_EXCL, 0644);
+
+        if (fd < 0 && errno == EEXIST && isStaleSegment (segmentName))
+        {
+            shm_unlink (segmentName.toRawUTF8());
+            fd = shm_open (segmentName.toRawUTF8(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        }
+
+        if (fd < 0)
+            continue;
+
+        auto* mem = ftruncate (fd, (off_t) size) == 0
+                        ? mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+                        : MAP_FAILED;
+        ::close (fd);
+
+        if (mem == MAP_FAILED)
+        {
+            shm_unlink (segmentName.toRawUTF8());
+            continue;
+        }
+
+        // Touch every page now, so the audio thread never takes the page faults
+        std::memset (mem, 0, size);
+
+        header = new (mem) SharedSpectrum::Header();
+        header->version = SharedSpectrum::version;
+        header->headerSize = headerSize;
+        header->slotSize = slotSize;
+        header->numSlots = (std::uint32_t) numSlots;
+        header->numBins = (std::uint32_t) numBins;
+        header->fftSize = (std::uint32_t) fftSize;
+        header->channelMode = channelMode;
+        header->sampleRate = sampleRate;
+        header->processId = (std::int64_t) getpid();
+        name.copyToUTF8 (header->name, SharedSpectrum::nameLength);
+        header->framesWritten.store (0);
+
+        for (int slot = 0; slot < numSlots; ++slot)
+            new (static_cast<juce::uint8*> (mem) + headerSize + (size_t) slot * slotSize) SharedSpectrum::Slot();
+
+        // Readers ignore the segment until the magic number shows up
+        std::atomic_ref<std::uint32_t> (header->magic).store (SharedSpectrum::magic, std::memory_order_release);
+
+        mappedSize = size;
+        instanceIndex = index;
+        return true;
+    }
+   #endif
+
+    return false;
+}
+
+void SharedSpectrumExport::close()
+{
+   #if SIMPLE_ANALYZER_SHARED_MEMORY
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    if (header == nullptr)
+        return;
+
+    std::atomic_ref<std::uint32_t> (header->magic).store (0, std::memory_order_release);
+    munmap (header, mappedSize);
+    shm_unlink (getSegmentName (instanceIndex).toRawUTF8());
+
+    header = nullptr;
+    mappedSize = 0;
+    instanceIndex = -1;
+   #endif
+}
+
+void SharedSpectrumExport::setFormat (double newSampleRate, SharedSpectrum::ChannelMode newChannelMode)
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    sampleRate = newSampleRate;
+    channelMode = newChannelMode;
+
+    if (header != nullptr)
+    {
+        header->sampleRate = sampleRate;
+        header->channelMode = channelMode;
+    }
+}
+
+void SharedSpectrumExport::setName (const juce::String& newName)
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    name = newName;
+
+    if (header != nullptr)
+        name.copyToUTF8 (header->name, SharedSpectrum::nameLength);
+}
+
+juce::uint8* SharedSpectrumExport::getSlot (std::uint64_t frame) const
+{
+    auto* base = reinterpret_cast<juce::uint8*> (header) + header->headerSize;
+    return base + (size_t) (frame % (std::uint64_t) numSlots) * header->slotSize;
+}
+
+void SharedSpectrumExport::publish (const float* magnitudes, float scale)
+{
+    const juce::SpinLock::ScopedTryLockType sl (lock);
+
+    if (not sl.isLocked() || header == nullptr)
+        return;
+
+    auto frame = header->framesWritten.load (std::memory_order_relaxed);
+    auto* slot = reinterpret_cast<SharedSpectrum::Slot*> (getSlot (frame));
+
+    // Odd sequence while we write, readers retry if they see it or it changes under them
+    auto sequence = slot->sequence.load (std::memory_order_relaxed);
+    slot->sequence.store (sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    slot->frameNumber = frame;
+    slot->time = juce::Time::getMillisecondCounterHiRes();
+    juce::FloatVectorOperations::multiply (slot->getLevels(), magnitudes, scale, numBins);
+
+    slot->sequence.store (sequence + 2, std::memory_order_release);
+    header->framesWritten.store (frame + 1, std::memory_order_release);
+}
@@ -0,0 +1,63 @@
+/*
+==============================================================================
+
+    SharedSpectrumExport.h
+    Created: 19 Oct 2026 4:08:42am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "SharedSpectrumLayout.h"
+
+//==============================================================================
+/*
+    Writer side of the shared-memory frame export, see SharedSpectrumLayout.h.
+
+    open() and close() create and remove the segment on the message thread.
+    publish() writes a frame straight into the mapped ring from the audio
+    thread. It only ever tries the lock, so if the segment is being opened or
+    closed at that moment the frame is skipped rather than waited for.
+
+    Only POSIX platforms have an implementation, elsewhere open() fails.
+*/
+
+class SharedSpectrumExport
+{
+public:
+    SharedSpectrumExport (int numBins, int fftSize);
+    ~SharedSpectrumExport();
+
+    // Message thread
+    bool open();
+    void close();
+    bool isOpen() const { return header != nullptr; }
+    int getInstanceIndex() const { return instanceIndex; }
+
+    void setFormat (double sampleRate, SharedSpectrum::ChannelMode channelMode);
+    void setName (const juce::String& name);
+
+    // Audio thread. magnitudes holds numBins values, scale turns them into the exported scale.
+    void publish (const float* magnitudes, float scale);
+
+private:
+    juce::uint8* getSlot (std::uint64_t frame) const;
+
+    const int numBins;
+    const int fftSize;
+    const int numSlots = 64;
+
+    juce::SpinLock lock;
+    SharedSpectrum::Header* header = nullptr;
+    size_t mappedSize = 0;
+    int instanceIndex = -1;
+
+    double sampleRate = 44100.0;
+    SharedSpectrum::ChannelMode channelMode = SharedSpectrum::stereo;
+    juce::String name;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedSpectrumExport)
+};
@@ -0,0 +1,91 @@
+/*
+==============================================================================
+
+    SharedSpectrumLayout.h
+    Created: 19 Oct 2026 4:08:42am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+// Plain C++ on purpose, the reader library includes this without JUCE
+#include <atomic>
+#include <cstdint>
+
+//==============================================================================
+/*
+    Memory layout of the shared-memory segment each plugin instance exports
+    its frames through, when the export is switched on.
+
+    Segments are named "/simple-analyzer.<index>", index from 0 to
+    maxInstances - 1, so readers find every instance by trying each name. The
+    segment is a header followed by numSlots frame slots, used as a ring: frame
+    f goes into slot f % numSlots.
+
+    Every slot is guarded by a seqlock. The writer makes the sequence odd,
+    writes the slot and makes it even again. A reader copies the slot between
+    two loads of the sequence, and only trusts the copy if both loads were the
+    same even number.
+*/
+
+namespace SharedSpectrum
+{
+    constexpr const char* namePrefix = "/simple-analyzer.";
+    constexpr int maxInstances = 64;
+    constexpr std::uint32_t magic = 0x53414e31; // "SAN1"
+    constexpr std::uint32_t version = 1;
+    constexpr int nameLength = 64;
+
+    enum ChannelMode : std::uint32_t
+    {
+        mono = 0,
+        stereo = 1
+    };
+
+    static_assert (std::atomic<std::uint64_t>::is_always_lock_free,
+                   "The counters have to be lock-free to work across processes");
+
+    struct Header
+    {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint32_t headerSize;   // Offset of the first slot
+        std::uint32_t slotSize;     // Bytes per slot, including the levels
+        std::uint32_t numSlots;
+        std::uint32_t numBins;
+        std::uint32_t fftSize;
+        std::uint32_t channelMode;
+        double sampleRate;
+        std::int64_t processId;     // Of the writer, so stale segments can be spotted
+        char name[nameLength];      // Track name when the host tells us, null terminated
+
+        std::atomic<std::uint64_t> framesWritten; // Newest frame is framesWritten - 1
+    };
+
+    struct Slot
+    {
+        std::atomic<std::uint32_t> sequence;
+        std::uint32_t reserved;
+        std::uint64_t frameNumber;
+        double time;                // Milliseconds, writer's hi-res counter
+
+        // numBins smoothed magnitudes follow, divided by the FFT size. In dB
+        // that's the scale the analyzer draws.
+        float* getLevels()             { return reinterpret_cast<float*> (this + 1); }
+        const float* getLevels() const { return reinterpret_cast<const float*> (this + 1); }
+    };
+
+    inline std::uint32_t getSlotSize (std::uint32_t numBins)
+    {
+        // Keep every slot 64-byte aligned so two slots never share a cache line
+        auto size = (std::uint32_t) (sizeof (Slot) + numBins * sizeof (float));
+        return (size + 63u) & ~63u;
+    }
+
+    inline std::uint32_t getHeaderSize()
+    {
+        return ((std::uint32_t) sizeof (Header) + 63u) & ~63u;
+    }
+}
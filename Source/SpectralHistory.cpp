@@ -0,0 +1,260 @@
+/*
+==============================================================================
+
+    SpectralHistory.cpp
+    Created: 19 Oct 2026 4:05:19am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "SpectralHistory.h"
+
+//==============================================================================
+SpectralHistory::SpectralHistory (int bins, double seconds, double framesPerSecond, Precision p, bool deltas)
+    : numBins (bins),
+      precision (p),
+      useDeltas (deltas),
+      stepDb (p == Precision::eightBit ? 0.5f : 1.0f / 32.0f),
+      maxValue (p == Precision::eightBit ? 255 : 4095)
+{
+    // Enough bytes for the whole duration even if every frame were a keyframe.
+    // With deltas the same bytes hold more frames, so the frame ring gets room for twice as many.
+    auto numKeyframes = (size_t) std::ceil (seconds * framesPerSecond);
+
+    storage.resize (numKeyframes * getRecordSize (true));
+    frames.resize (numKeyframes * (useDeltas ? 2 : 1));
+
+    current.resize ((size_t) numBins, 0);
+    previous.resize ((size_t) numBins, 0);
+    decoded.resize ((size_t) numBins, 0);
+}
+
+void SpectralHistory::clear()
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    writeOffset = 0;
+    firstFrame = 0;
+    numFrames = 0;
+    framesSinceKeyframe = 0;
+}
+
+size_t SpectralHistory::getRecordSize (bool isKeyframe) const
+{
+    auto pairs = (size_t) (numBins + 1) / 2;
+
+    // One byte for the record type, then the bins
+    if (precision == Precision::eightBit)
+        return 1 + (isKeyframe ? (size_t) numBins : pairs);      // 8 bit values or 4 bit deltas
+
+    return 1 + (isKeyframe ? pairs * 3 : (size_t) numBins);      // 12 bit values or 8 bit deltas
+}
+
+const SpectralHistory::FrameInfo& SpectralHistory::getFrame (int index) const
+{
+    jassert (index >= 0 && index < numFrames);
+    return frames[(size_t) ((firstFrame + index) % (int) frames.size())];
+}
+
+int SpectralHistory::getNumFrames() const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    return numFrames;
+}
+
+double SpectralHistory::getFrameTime (int index) const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+    return getFrame (index).time;
+}
+
+void SpectralHistory::evictOldest()
+{
+    firstFrame = (firstFrame + 1) % (int) frames.size();
+    --numFrames;
+}
+
+void SpectralHistory::push (const float* levelsDb, double time)
+{
+    const juce::SpinLock::ScopedTryLockType sl (lock);
+
+    if (not sl.isLocked())
+        return;
+
+    for (int n = 0; n < numBins; ++n)
+        current[(size_t) n] = juce::jlimit (0, maxValue, juce::roundToInt ((levelsDb[n] - minDb) / stepDb));
+
+    // Deltas need the previous frame, and a keyframe every so often keeps decoding cheap
+    auto isKeyframe = not useDeltas || numFrames == 0 || framesSinceKeyframe >= keyframeInterval - 1;
+
+    if (not isKeyframe)
+    {
+        auto lowest = precision == Precision::eightBit ? -8 : -128;
+        auto highest = precision == Precision::eightBit ? 7 : 127;
+
+        for (int n = 0; n < numBins && not isKeyframe; ++n)
+        {
+            auto delta = current[(size_t) n] - previous[(size_t) n];
+            isKeyframe = delta < lowest || delta > highest;
+        }
+    }
+
+    auto size = getRecordSize (isKeyframe);
+
+    if (size > storage.size())
+        return;
+
+    // Records never straddle the end of the ring
+    if (writeOffset + size > storage.size())
+        writeOffset = 0;
+
+    // Make room: drop the oldest frames while their records overlap the new one
+    // or the frame ring is full
+    auto overlaps = [&] (const FrameInfo& frame)
+    {
+        auto frameEnd = frame.offset + getRecordSize (frame.isKeyframe);
+        return frame.offset < writeOffset + size && writeOffset < frameEnd;
+    };
+
+    while (numFrames > 0 && (numFrames == (int) frames.size() || overlaps (getFrame (0))))
+        evictOldest();
+
+    // A delta is no use without the keyframe before it
+    while (numFrames > 0 && not getFrame (0).isKeyframe)
+        evictOldest();
+
+    // That includes this one, when making room for it took its keyframe and
+    // so the whole chain. It's stored in full after all.
+    if (numFrames == 0 && not isKeyframe)
+    {
+        isKeyframe = true;
+        size = getRecordSize (true);
+
+        if (writeOffset + size > storage.size())
+            writeOffset = 0;
+    }
+
+    auto* dest = storage.data() + writeOffset;
+    dest[0] = isKeyframe ? 1 : 0;
+
+    if (isKeyframe)
+        writeKeyframe (dest + 1);
+    else
+        writeDeltas (dest + 1);
+
+    auto& frame = frames[(size_t) ((firstFrame + numFrames) % (int) frames.size())];
+    frame.offset = writeOffset;
+    frame.time = time;
+    frame.isKeyframe = isKeyframe;
+    ++numFrames;
+
+    writeOffset += size;
+    framesSinceKeyframe = isKeyframe ? 0 : framesSinceKeyframe + 1;
+    std::swap (current, previous);
+}
+
+void SpectralHistory::writeKeyframe (juce::uint8* dest) const
+{
+    if (precision == Precision::eightBit)
+    {
+        for (int n = 0; n < numBins; ++n)
+            dest[n] = (juce::uint8) current[(size_t) n];
+
+        return;
+    }
+
+    // Two 12 bit values in three bytes
+    for (int n = 0; n < numBins; n += 2)
+    {
+        auto a = current[(size_t) n];
+        auto b = n + 1 < numBins ? current[(size_t) n + 1] : 0;
+
+        *dest++ = (juce::uint8) (a & 0xff);
+        *dest++ = (juce::uint8) ((a >> 8) | ((b & 0x0f) << 4));
+        *dest++ = (juce::uint8) (b >> 4);
+    }
+}
+
+void SpectralHistory::writeDeltas (juce::uint8* dest) const
+{
+    if (precision == Precision::twelveBit)
+    {
+        for (int n = 0; n < numBins; ++n)
+            dest[n] = (juce::uint8) (juce::int8) (current[(size_t) n] - previous[(size_t) n]);
+
+        return;
+    }
+
+    // Two 4 bit deltas per byte, offset by 8
+    for (int n = 0; n < numBins; n += 2)
+    {
+        auto a = current[(size_t) n] - previous[(size_t) n] + 8;
+        auto b = n + 1 < numBins ? current[(size_t) n + 1] - previous[(size_t) n + 1] + 8 : 8;
+
+        *dest++ = (juce::uint8) (a | (b << 4));
+    }
+}
+
+void SpectralHistory::readKeyframe (const juce::uint8* source, std::vector<int>& values) const
+{
+    if (precision == Precision::eightBit)
+    {
+        for (int n = 0; n < numBins; ++n)
+            values[(size_t) n] = source[n];
+
+        return;
+    }
+
+    for (int n = 0; n < numBins; n += 2)
+    {
+        int b0 = *source++;
+        int b1 = *source++;
+        int b2 = *source++;
+
+        values[(size_t) n] = b0 | ((b1 & 0x0f) << 8);
+
+        if (n + 1 < numBins)
+            values[(size_t) n + 1] = (b1 >> 4) | (b2 << 4);
+    }
+}
+
+void SpectralHistory::applyDeltas (const juce::uint8* source, std::vector<int>& values) const
+{
+    if (precision == Precision::twelveBit)
+    {
+        for (int n = 0; n < numBins; ++n)
+            values[(size_t) n] += (juce::int8) source[n];
+
+        return;
+    }
+
+    for (int n = 0; n < numBins; n += 2)
+    {
+        int packed = *source++;
+
+        values[(size_t) n] += (packed & 0x0f) - 8;
+
+        if (n + 1 < numBins)
+            values[(size_t) n + 1] += (packed >> 4) - 8;
+    }
+}
+
+void SpectralHistory::decode (int index, float* levelsDb) const
+{
+    const juce::SpinLock::ScopedLockType sl (lock);
+
+    // Back to the keyframe this frame builds on, then forward through the deltas
+    auto key = index;
+
+    while (key > 0 && not getFrame (key).isKeyframe)
+        --key;
+
+    readKeyframe (storage.data() + getFrame (key).offset + 1, decoded);
+
+    for (int i = key + 1; i <= index; ++i)
+        applyDeltas (storage.data() + getFrame (i).offset + 1, decoded);
+
+    for (int n = 0; n < numBins; ++n)
+        levelsDb[n] = minDb + (float) decoded[(size_t) n] * stepDb;
+}
@@ -0,0 +1,103 @@
+/*
+==============================================================================
+
+    SpectralHistory.h
+    Created: 19 Oct 2026 4:05:19am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    The last few minutes of spectrum frames, kept small enough to leave running.
+
+    Each frame is stored as quantised dB levels, 8 bit (0.5 dB steps) or 12 bit
+    (1/32 dB steps), instead of raw floats. With deltas turned on, a frame whose
+    bins all moved by only a few steps since the previous one is stored as the
+    differences, at half the size or less. Every keyframeInterval frames there's
+    a full frame, so decoding any frame never needs more than that many steps.
+
+    Records go into one preallocated byte ring. New frames evict the oldest
+    ones, and a delta frame whose keyframe has been evicted goes with it.
+    Frames are only decoded when asked for, for viewing.
+
+    One thread pushes and others read. The pusher never waits: a frame that
+    arrives while a reader holds the lock is left out.
+*/
+
+class SpectralHistory
+{
+public:
+    enum class Precision
+    {
+        eightBit,
+        twelveBit
+    };
+
+    enum
+    {
+        keyframeInterval = 32
+    };
+
+    SpectralHistory (int numBins, double seconds, double framesPerSecond, Precision precision, bool useDeltas);
+
+    void clear();
+
+    // levelsDb holds numBins levels on the display's dB scale. time is in milliseconds.
+    void push (const float* levelsDb, double time);
+
+    // Frames are indexed from 0, the oldest, to getNumFrames() - 1, the newest.
+    // The indices only stay put while nothing is being pushed.
+    int getNumFrames() const;
+    double getFrameTime (int index) const;
+    void decode (int index, float* levelsDb) const;
+
+    size_t getStorageSize() const { return storage.size(); }
+
+private:
+    struct FrameInfo
+    {
+        size_t offset = 0;
+        double time = 0.0;
+        bool isKeyframe = true;
+    };
+
+    const FrameInfo& getFrame (int index) const;
+    size_t getRecordSize (bool isKeyframe) const;
+    void evictOldest();
+
+    void writeKeyframe (juce::uint8* dest) const;
+    void writeDeltas (juce::uint8* dest) const;
+    void readKeyframe (const juce::uint8* source, std::vector<int>& values) const;
+    void applyDeltas (const juce::uint8* source, std::vector<int>& values) const;
+
+    const int numBins;
+    const Precision precision;
+    const bool useDeltas;
+    const float minDb = -120.0f;
+    const float stepDb;
+    const int maxValue;
+
+    std::vector<juce::uint8> storage;
+    size_t writeOffset = 0;
+
+    // Ring of frame records, oldest at firstFrame
+    std::vector<FrameInfo> frames;
+    int firstFrame = 0;
+    int numFrames = 0;
+    int framesSinceKeyframe = 0;
+
+    // Quantised values of the frame being pushed and the one before it
+    std::vector<int> current;
+    std::vector<int> previous;
+    mutable std::vector<int> decoded;
+
+    mutable juce::SpinLock lock;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectralHistory)
+};
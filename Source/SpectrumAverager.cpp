@@ -0,0 +1,141 @@
+/*
+==============================================================================
+
+    SpectrumAverager.cpp
+    Created: 19 Oct 2026 3:57:15am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "SpectrumAverager.h"
+
+//==============================================================================
+SpectrumAverager::SpectrumAverager (int bins, int frames)
+    : numBins (bins),
+      maxFrames (frames)
+{
+    jassert (numBins > 0 && maxFrames > 0);
+
+    ring.resize ((size_t) (maxFrames * numBins), 0.0f);
+    runningSum.resize ((size_t) numBins, 0.0f);
+    infiniteSum.resize ((size_t) numBins, 0.0);
+}
+
+void SpectrumAverager::setMode (Mode newMode)
+{
+    requestedMode = newMode;
+}
+
+void SpectrumAverager::setNumFrames (int newNumFrames)
+{
+    requestedFrames = juce::jlimit (1, maxFrames, newNumFrames);
+}
+
+void SpectrumAverager::reset()
+{
+    resetRequested = true;
+}
+
+void SpectrumAverager::clearState()
+{
+    // The ring itself doesn't need zeroing, numFilled tells us which frames are valid
+    std::fill (runningSum.begin(), runningSum.end(), 0.0f);
+    std::fill (infiniteSum.begin(), infiniteSum.end(), 0.0);
+    writeFrame = 0;
+    numFilled = 0;
+    infiniteCount = 0;
+}
+
+void SpectrumAverager::process (const float* input, float* output, float leak)
+{
+    auto newMode = requestedMode.load();
+    auto newFrames = requestedFrames.load();
+
+    // A new mode or frame count invalidates whatever we've accumulated so far
+    if (resetRequested.exchange (false) || newMode != mode || newFrames != numFrames)
+    {
+        mode = newMode;
+        numFrames = newFrames;
+        clearState();
+    }
+
+    switch (mode)
+    {
+        case Mode::linear:
+            processLinear (input, output);
+            break;
+
+        case Mode::infinite:
+            processInfinite (input, output);
+            break;
+
+        case Mode::exponential:
+        default:
+            for (int n = 0; n < numBins; ++n)
+                output[n] = leak * output[n] + (1 - leak) * input[n];
+            break;
+    }
+}
+
+void SpectrumAverager::processLinear (const float* input, float* output)
+{
+    auto* slot = ring.data() + (size_t) (writeFrame * numBins);
+    auto* sum = runningSum.data();
+
+    // Once the ring is full, the frame we're about to overwrite drops out of the sum
+    if (numFilled == numFrames)
+    {
+        for (int n = 0; n < numBins; ++n)
+            sum[n] += input[n] - slot[n];
+    }
+    else
+    {
+        for (int n = 0; n < numBins; ++n)
+            sum[n] += input[n];
+
+        ++numFilled;
+    }
+
+    std::copy (input, input + numBins, slot);
+
+    if (++writeFrame == numFrames)
+    {
+        writeFrame = 0;
+
+        // Adding and subtracting the same values in float slowly drifts,
+        // so rebuild the sum from the ring once per trip around it
+        renormalise();
+    }
+
+    auto scale = 1.0f / (float) numFilled;
+
+    for (int n = 0; n < numBins; ++n)
+        output[n] = juce::jmax (0.0f, sum[n] * scale);
+}
+
+void SpectrumAverager::renormalise()
+{
+    auto* sum = runningSum.data();
+    std::fill (runningSum.begin(), runningSum.end(), 0.0f);
+
+    for (int f = 0; f < numFilled; ++f)
+    {
+        const auto* frame = ring.data() + (size_t) (f * numBins);
+
+        for (int n = 0; n < numBins; ++n)
+            sum[n] += frame[n];
+    }
+}
+
+void SpectrumAverager::processInfinite (const float* input, float* output)
+{
+    ++infiniteCount;
+    auto scale = 1.0 / (double) infiniteCount;
+
+    for (int n = 0; n < numBins; ++n)
+    {
+        infiniteSum[(size_t) n] += input[n];
+        output[n] = (float) (infiniteSum[(size_t) n] * scale);
+    }
+}
@@ -0,0 +1,77 @@
+/*
+==============================================================================
+
+    SpectrumAverager.h
+    Created: 19 Oct 2026 3:57:15am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Averages successive magnitude frames. Besides the exponential leak we've
+    always had, it can do a linear average over the last N frames (kept as a
+    ring of frames plus a running sum) and an infinite average accumulated in
+    double precision until reset.
+
+    All the memory is allocated up front for the maximum N, so switching modes
+    or frame counts from the audio thread never allocates.
+*/
+
+class SpectrumAverager
+{
+public:
+    enum class Mode
+    {
+        exponential = 0,
+        linear,
+        infinite
+    };
+
+    SpectrumAverager (int numBins, int maxFrames);
+
+    // These can be called from any thread, changes are picked up on the next frame
+    void setMode (Mode newMode);
+    void setNumFrames (int newNumFrames);
+    void reset();
+
+    // Called once per FFT frame on the audio thread. For the exponential mode,
+    // output also holds the previous average.
+    void process (const float* input, float* output, float leak);
+
+    int getNumBins() const   { return numBins; }
+    int getMaxFrames() const { return maxFrames; }
+
+private:
+    void clearState();
+    void processLinear (const float* input, float* output);
+    void processInfinite (const float* input, float* output);
+    void renormalise();
+
+    const int numBins;
+    const int maxFrames;
+
+    std::atomic<Mode> requestedMode { Mode::exponential };
+    std::atomic<int> requestedFrames { 1 };
+    std::atomic<bool> resetRequested { false };
+
+    Mode mode = Mode::exponential;
+    int numFrames = 1;
+
+    // Linear mode: ring of the last numFrames frames and their running sum
+    std::vector<float> ring;    // maxFrames * numBins
+    std::vector<float> runningSum;
+    int writeFrame = 0;
+    int numFilled = 0;
+
+    // Infinite mode
+    std::vector<double> infiniteSum;
+    juce::int64 infiniteCount = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumAverager)
+};
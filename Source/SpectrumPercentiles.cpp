@@ -0,0 +1,171 @@
+/*
+==============================================================================
+
+    SpectrumPercentiles.cpp
+    Created: 19 Oct 2026 4:39:09am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "SpectrumPercentiles.h"
+
+static constexpr double updatesPerSecond = 4.0;
+
+//==============================================================================
+SpectrumPercentiles::SpectrumPercentiles (int bins, int size)
+    : numBins (bins),
+      fftSize (size),
+      binsPerColumn ((bins + maxColumns - 1) / maxColumns),
+      numColumns ((bins + binsPerColumn - 1) / binsPerColumn)
+{
+    jassert (numBins > 0);
+
+    totals.resize ((size_t) (numColumns * numBuckets), 0);
+    segments.resize ((size_t) (numSegments * numColumns * numBuckets), 0);
+}
+
+void SpectrumPercentiles::prepare (double sampleRate)
+{
+    // One frame per FFT's worth of samples, the FIFO doesn't overlap them
+    framesPerSecond = sampleRate / fftSize;
+    framesPerUpdate = juce::jmax (1, juce::roundToInt (framesPerSecond / updatesPerSecond));
+
+    // The bottom of the lowest bucket as a magnitude, on the display's scale of magnitude / fftSize
+    minMagnitude = (float) fftSize * juce::Decibels::decibelsToGain (minDb, -1000.0f);
+
+    windowSeconds = -1.0;
+}
+
+void SpectrumPercentiles::setWindowSeconds (double newSeconds)
+{
+    requestedSeconds = juce::jmax (0.0, newSeconds);
+}
+
+void SpectrumPercentiles::reset()
+{
+    resetRequested = true;
+}
+
+void SpectrumPercentiles::clearState()
+{
+    std::fill (totals.begin(), totals.end(), 0);
+    std::fill (segments.begin(), segments.end(), 0);
+    segmentFrameCounts.fill (0);
+    currentSegment = 0;
+    totalFrames = 0;
+    framesSinceUpdate = 0;
+}
+
+void SpectrumPercentiles::processFrame (const float* magnitudes, Result& result)
+{
+    auto newSeconds = requestedSeconds.load();
+
+    if (resetRequested.exchange (false) || newSeconds != windowSeconds)
+    {
+        windowSeconds = newSeconds;
+
+        // A segment's counts have to fit in 16 bits, which still allows windows of over an hour at 192 kHz
+        segmentFrames = windowSeconds > 0.0 ? juce::jlimit (1, 65535, (int) std::ceil (windowSeconds * framesPerSecond / numSegments))
+                                            : 0;
+        clearState();
+        result.numColumns = 0;
+    }
+
+    auto* segment = segmentFrames > 0 ? segments.data() + (size_t) (currentSegment * numColumns * numBuckets)
+                                      : nullptr;
+    auto referenceDb = juce::Decibels::gainToDecibels ((float) fftSize);
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        auto first = column * binsPerColumn;
+        auto last = juce::jmin (numBins, first + binsPerColumn);
+        auto magnitude = *std::max_element (magnitudes + first, magnitudes + last);
+
+        auto bucket = 0;
+
+        if (magnitude > minMagnitude)
+            bucket = juce::jmin (numBuckets - 1, (int) (20.0f * std::log10 (magnitude) - referenceDb - minDb));
+
+        auto index = (size_t) (column * numBuckets + bucket);
+        ++totals[index];
+
+        if (segment != nullptr)
+            ++segment[index];
+    }
+
+    ++totalFrames;
+
+    if (segment != nullptr && ++segmentFrameCounts[(size_t) currentSegment] == segmentFrames)
+        startNextSegment();
+
+    if (++framesSinceUpdate >= framesPerUpdate)
+    {
+        framesSinceUpdate = 0;
+        updateResult (result);
+    }
+}
+
+void SpectrumPercentiles::startNextSegment()
+{
+    currentSegment = (currentSegment + 1) % numSegments;
+
+    auto& frameCount = segmentFrameCounts[(size_t) currentSegment];
+
+    if (frameCount == 0)
+        return;
+
+    // The oldest segment leaves the window. This is the only pass over all the
+    // counts, and it comes once every segmentFrames frames.
+    auto* oldest = segments.data() + (size_t) (currentSegment * numColumns * numBuckets);
+
+    for (size_t i = 0; i < totals.size(); ++i)
+        totals[i] -= oldest[i];
+
+    std::fill (oldest, oldest + totals.size(), 0);
+    totalFrames -= frameCount;
+    frameCount = 0;
+}
+
+void SpectrumPercentiles::updateResult (Result& result) const
+{
+    if (totalFrames == 0)
+    {
+        result.numColumns = 0;
+        return;
+    }
+
+    std::array<double, numPercentiles> targets;
+
+    for (size_t p = 0; p < targets.size(); ++p)
+        targets[p] = (double) totalFrames * percentExceeded[p] / 100.0;
+
+    for (int column = 0; column < numColumns; ++column)
+    {
+        // Counting down from the loudest bucket, a level is exceeded p % of the
+        // time once p % of the frames are above it. Within a bucket the counts
+        // are taken to be spread evenly.
+        const auto* counts = totals.data() + (size_t) (column * numBuckets);
+        auto above = 0.0;
+        size_t p = 0;
+
+        for (int bucket = numBuckets - 1; bucket >= 0 && p < targets.size(); --bucket)
+        {
+            auto count = (double) counts[bucket];
+
+            for (; p < targets.size() && above + count >= targets[p]; ++p)
+            {
+                auto fraction = count > 0.0 ? (targets[p] - above) / count : 0.0;
+                result.levelsDb[p][(size_t) column] = minDb + (float) ((double) bucket + 1.0 - fraction);
+            }
+
+            above += count;
+        }
+
+        for (; p < targets.size(); ++p)
+            result.levelsDb[p][(size_t) column] = minDb;
+    }
+
+    result.numColumns = numColumns;
+    result.seconds = (double) totalFrames / framesPerSecond;
+}
@@ -0,0 +1,97 @@
+/*
+==============================================================================
+
+    SpectrumPercentiles.h
+    Created: 19 Oct 2026 4:39:09am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Statistical levels per bin over the last few minutes or the whole session:
+    L10, L50 and L90, the levels exceeded 10, 50 and 90 % of the time (the
+    90th, 50th and 10th percentiles).
+
+    Rather than keeping the frames and sorting them, each bin has a histogram
+    of 1 dB buckets, and a frame adds one count to each. A percentile is a walk
+    down a histogram until enough counts are passed, done a few times a second.
+
+    For a sliding window the counts also go into one of numSegments segment
+    histograms in turn. When the oldest segment has aged out its counts are
+    taken off the totals and it's reused, so the window covers between
+    (numSegments - 1) / numSegments of the time asked for and all of it.
+
+    Bins beyond maxColumns are grouped, each group counting its loudest bin,
+    so the memory stays the same at any FFT size and for any length of time.
+    It's all allocated up front.
+*/
+
+class SpectrumPercentiles
+{
+public:
+    static constexpr int numPercentiles = 3;
+    static constexpr int maxColumns = 1024;
+    static constexpr int numSegments = 8;
+    static constexpr int numBuckets = 128;
+    static constexpr float minDb = -120.0f; // Bottom of the lowest bucket, on the display's scale
+
+    // Percentage of the time each level is exceeded, in increasing order
+    static constexpr std::array<float, numPercentiles> percentExceeded { 10.0f, 50.0f, 90.0f };
+
+    struct Result
+    {
+        int numColumns = 0;     // 0 until there's something to show
+        double seconds = 0.0;   // Programme the levels are taken from
+        std::array<std::array<float, maxColumns>, numPercentiles> levelsDb {}; // L10, L50, L90
+    };
+
+    SpectrumPercentiles (int numBins, int fftSize);
+
+    void prepare (double sampleRate);
+
+    // Any thread, picked up by the next frame. 0 seconds is the whole session.
+    void setWindowSeconds (double newSeconds);
+    void reset();
+
+    // Audio thread, once per frame of fftSize / 2 magnitudes. The result is
+    // only refreshed a few times a second.
+    void processFrame (const float* magnitudes, Result& result);
+
+private:
+    void clearState();
+    void startNextSegment();
+    void updateResult (Result& result) const;
+
+    const int numBins;
+    const int fftSize;
+    const int binsPerColumn;
+    const int numColumns;
+
+    double framesPerSecond = 44100.0 / 2048.0;
+    int framesPerUpdate = 1;
+    int framesSinceUpdate = 0;
+
+    std::atomic<double> requestedSeconds { 0.0 };
+    std::atomic<bool> resetRequested { false };
+    double windowSeconds = -1.0; // Not applied yet
+
+    // Magnitudes below this land in the bottom bucket, and it saves a log for each bin that's quieter
+    float minMagnitude = 0.0f;
+
+    // numColumns histograms of numBuckets counts each. The segments are only
+    // used for a sliding window, and a segment never holds more than segmentFrames.
+    std::vector<juce::uint32> totals;
+    std::vector<juce::uint16> segments;
+    std::array<int, numSegments> segmentFrameCounts {};
+    int segmentFrames = 0;
+    int currentSegment = 0;
+    juce::int64 totalFrames = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumPercentiles)
+};
@@ -0,0 +1,98 @@
+/*
+==============================================================================
+
+    SpectrumWeighting.cpp
+    Created: 19 Oct 2026 4:28:09am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "SpectrumWeighting.h"
+
+static constexpr double pivotFrequency = 1000.0;
+
+//==============================================================================
+SpectrumWeighting::SpectrumWeighting (int size)
+    : fftSize (size),
+      gains ((size_t) size / 2, 1.0f)
+{
+}
+
+void SpectrumWeighting::prepare (double sampleRate)
+{
+    fs = sampleRate;
+    builtVersion = -1;
+}
+
+void SpectrumWeighting::setCurve (Curve newCurve)
+{
+    requestedCurve = newCurve;
+    ++requestedVersion;
+}
+
+void SpectrumWeighting::setTilt (float newDbPerOctave)
+{
+    requestedTilt = newDbPerOctave;
+    ++requestedVersion;
+}
+
+const float* SpectrumWeighting::update()
+{
+    if (builtVersion != requestedVersion.load())
+        rebuild();
+
+    return isFlat ? nullptr : gains.data();
+}
+
+float SpectrumWeighting::getCurveDb (Curve curve, double frequency)
+{
+    // Pole frequencies from IEC 61672-1, with the offsets that make both 0 dB at 1 kHz
+    constexpr double f1 = 20.598997, f2 = 107.65265, f3 = 737.86223, f4 = 12194.217;
+    auto f = frequency * frequency;
+
+    switch (curve)
+    {
+        case Curve::a:
+        {
+            auto response = f4 * f4 * f * f / ((f + f1 * f1) * std::sqrt ((f + f2 * f2) * (f + f3 * f3)) * (f + f4 * f4));
+            return (float) (20.0 * std::log10 (response) + 2.0);
+        }
+
+        case Curve::c:
+        {
+            auto response = f4 * f4 * f / ((f + f1 * f1) * (f + f4 * f4));
+            return (float) (20.0 * std::log10 (response) + 0.062);
+        }
+
+        case Curve::z:
+        default:
+            return 0.0f;
+    }
+}
+
+float SpectrumWeighting::getGainDb (Curve curve, float tiltDbPerOctave, double frequency)
+{
+    return getCurveDb (curve, frequency) + (float) (tiltDbPerOctave * std::log2 (frequency / pivotFrequency));
+}
+
+void SpectrumWeighting::rebuild()
+{
+    builtVersion = requestedVersion.load();
+
+    auto curve = requestedCurve.load();
+    auto tilt = requestedTilt.load();
+    auto binWidth = fs / (double) fftSize;
+
+    isFlat = curve == Curve::z && tilt == 0.0f;
+
+    if (isFlat)
+        return;
+
+    // DC takes the gain of the first bin, rather than the -infinity the curves give it
+    for (size_t n = 0; n < gains.size(); ++n)
+    {
+        auto frequency = (double) juce::jmax ((size_t) 1, n) * binWidth;
+        gains[n] = juce::Decibels::decibelsToGain (getGainDb (curve, tilt, frequency), -1000.0f);
+    }
+}
@@ -0,0 +1,70 @@
+/*
+==============================================================================
+
+    SpectrumWeighting.h
+    Created: 19 Oct 2026 4:28:09am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Per-bin gains for A or C frequency weighting (IEC 61672) and a display tilt
+    in dB per octave, pivoting at 1 kHz. A tilt of 3 dB/oct shows pink noise
+    flat, 4.5 dB/oct is closer to how a mix is usually judged.
+
+    The gain table is rebuilt on the audio thread only when a setting or the
+    sample rate changes. The pipeline applies it while it computes the
+    magnitudes, so the weighting is one more multiply in a loop that already
+    runs, and paint never sees it.
+*/
+
+class SpectrumWeighting
+{
+public:
+    enum class Curve
+    {
+        z = 0, // Flat
+        a,
+        c
+    };
+
+    explicit SpectrumWeighting (int fftSize);
+
+    void prepare (double sampleRate);
+
+    // Any thread, picked up by the next update()
+    void setCurve (Curve newCurve);
+    void setTilt (float newDbPerOctave);
+
+    // Audio thread. Returns the gains for the fftSize / 2 bins, or nullptr
+    // when they'd all be 1 and there's no point multiplying.
+    const float* update();
+
+    // Weighting curves in dB, for anyone who wants to show them
+    static float getCurveDb (Curve curve, double frequency);
+
+    // The curve and the tilt together in dB, what a bin at this frequency is multiplied by
+    static float getGainDb (Curve curve, float tiltDbPerOctave, double frequency);
+
+private:
+    void rebuild();
+
+    const int fftSize;
+    double fs = 44100.0;
+
+    std::atomic<Curve> requestedCurve { Curve::z };
+    std::atomic<float> requestedTilt { 0.0f };
+    std::atomic<int> requestedVersion { 0 };
+    int builtVersion = -1;
+    bool isFlat = true;
+
+    std::vector<float> gains;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SpectrumWeighting)
+};
@@ -0,0 +1,86 @@
+/*
+==============================================================================
+
+    StereoCorrelation.cpp
+    Created: 19 Oct 2026 4:01:46am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "StereoCorrelation.h"
+
+//==============================================================================
+StereoCorrelation::StereoCorrelation (int fftOrder)
+    : fftSize (1 << fftOrder),
+      numBins (fftSize / 2),
+      fft (fftOrder),
+      window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann)
+{
+    rightSpectrum.resize ((size_t) (2 * fftSize), 0.0f);
+
+    sll.resize ((size_t) numBins, 0.0f);
+    srr.resize ((size_t) numBins, 0.0f);
+    slr.resize ((size_t) numBins, {});
+
+    phaseDifference.resize ((size_t) numBins, 0.0f);
+    correlation.resize ((size_t) numBins, 0.0f);
+    coherence.resize ((size_t) numBins, 0.0f);
+}
+
+void StereoCorrelation::prepare (double sampleRate)
+{
+    // About the integration time of a hardware correlation meter
+    const auto averagingTime = 0.3;
+    averaging = static_cast<float> (std::exp (-fftSize / (averagingTime * sampleRate)));
+
+    reset();
+}
+
+void StereoCorrelation::reset()
+{
+    std::fill (sll.begin(), sll.end(), 0.0f);
+    std::fill (srr.begin(), srr.end(), 0.0f);
+    std::fill (slr.begin(), slr.end(), std::complex<float>());
+    broadbandCorrelation = 0.0f;
+}
+
+void StereoCorrelation::processFrame (const float* leftSpectrum, const float* right)
+{
+    auto* r = rightSpectrum.data();
+
+    juce::zeromem (r, sizeof (float) * rightSpectrum.size());
+    memcpy (r, right, sizeof (float) * (size_t) fftSize);
+
+    window.multiplyWithWindowingTable (r, (size_t) fftSize);
+    fft.performRealOnlyForwardTransform (r, true);
+
+    const auto a = averaging;
+    const auto tiny = 1.0e-20f;
+
+    double totalLeft = 0.0, totalRight = 0.0, totalCross = 0.0;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        std::complex<float> L (leftSpectrum[2 * k], leftSpectrum[2 * k + 1]);
+        std::complex<float> R (r[2 * k], r[2 * k + 1]);
+
+        sll[(size_t) k] = a * sll[(size_t) k] + (1 - a) * std::norm (L);
+        srr[(size_t) k] = a * srr[(size_t) k] + (1 - a) * std::norm (R);
+        slr[(size_t) k] = a * slr[(size_t) k] + (1 - a) * L * std::conj (R);
+
+        auto power = sll[(size_t) k] * srr[(size_t) k];
+
+        phaseDifference[(size_t) k] = std::arg (slr[(size_t) k]);
+        correlation[(size_t) k] = power > tiny ? juce::jlimit (-1.0f, 1.0f, slr[(size_t) k].real() / std::sqrt (power)) : 0.0f;
+        coherence[(size_t) k] = power > tiny ? juce::jlimit (0.0f, 1.0f, std::norm (slr[(size_t) k]) / power) : 0.0f;
+
+        totalLeft += sll[(size_t) k];
+        totalRight += srr[(size_t) k];
+        totalCross += slr[(size_t) k].real();
+    }
+
+    // By Parseval the summed spectra give the same answer as correlating the windowed samples
+    auto totalPower = totalLeft * totalRight;
+    broadbandCorrelation = totalPower > tiny ? (float) juce::jlimit (-1.0, 1.0, totalCross / std::sqrt (totalPower)) : 0.0f;
+}
@@ -0,0 +1,64 @@
+/*
+==============================================================================
+
+    StereoCorrelation.h
+    Created: 19 Oct 2026 4:01:46am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Compares the left and right channels bin by bin. From the averaged auto
+    spectra Sll, Srr and the cross spectrum Slr we get the phase difference
+    arg(Slr), the correlation Re(Slr) / sqrt(Sll Srr), which runs from -1
+    (out of phase) to +1 (mono), and the coherence. Summing the same spectra
+    over all bins gives the broadband correlation a phase meter would show.
+
+    The left spectrum comes from the main analysis, so only the right channel
+    costs an extra transform.
+*/
+
+class StereoCorrelation
+{
+public:
+    explicit StereoCorrelation (int fftOrder);
+
+    void prepare (double sampleRate);
+    void reset();
+
+    // Audio thread: the complex left spectrum from the main analysis, and fftSize right samples
+    void processFrame (const float* leftSpectrum, const float* right);
+
+    int getNumBins() const { return numBins; }
+    const float* getPhaseDifference() const { return phaseDifference.data(); }
+    const float* getCorrelation() const { return correlation.data(); }
+    const float* getCoherence() const { return coherence.data(); }
+    float getBroadbandCorrelation() const { return broadbandCorrelation.load(); }
+
+private:
+    const int fftSize;
+    const int numBins;
+
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+    std::vector<float> rightSpectrum;
+
+    // Averaged auto and cross spectra
+    std::vector<float> sll, srr;
+    std::vector<std::complex<float>> slr;
+    float averaging = 0.0f;
+
+    // Published with each frame
+    std::vector<float> phaseDifference;
+    std::vector<float> correlation;
+    std::vector<float> coherence;
+    std::atomic<float> broadbandCorrelation { 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (StereoCorrelation)
+};
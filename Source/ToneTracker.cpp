@@ -0,0 +1,164 @@
+/*
+==============================================================================
+
+    ToneTracker.cpp
+    Created: 19 Oct 2026 4:26:55am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "ToneTracker.h"
+
+//==============================================================================
+ToneTracker::ToneTracker()
+    : history ((size_t) historySize, 0.0f),
+      traces ((size_t) (maxTargets * traceLength), floorDb)
+{
+    for (auto& frequency : requestedFrequencies)
+        frequency = 0.0f;
+
+    for (auto& frequency : trackedFrequencies)
+        frequency = 0.0f;
+}
+
+void ToneTracker::prepare (double sampleRate)
+{
+    fs = sampleRate;
+    samplesPerPoint = juce::jmax (1, juce::roundToInt (fs / traceRate));
+    samplesToNextPoint = samplesPerPoint;
+
+    std::fill (history.begin(), history.end(), 0.0f);
+    historyIndex = 0;
+
+    // Fit the targets to the new rate on the next block
+    appliedVersion = -1;
+}
+
+void ToneTracker::setTargets (const juce::Array<float>& frequencies)
+{
+    auto count = juce::jmin (frequencies.size(), maxTargets);
+
+    for (int t = 0; t < count; ++t)
+        requestedFrequencies[(size_t) t] = frequencies[t];
+
+    numRequested = count;
+    ++requestedVersion;
+}
+
+juce::Array<float> ToneTracker::getTargets() const
+{
+    juce::Array<float> frequencies;
+
+    for (int t = 0; t < numRequested.load(); ++t)
+        frequencies.add (requestedFrequencies[(size_t) t].load());
+
+    return frequencies;
+}
+
+void ToneTracker::applyTargets()
+{
+    appliedVersion = requestedVersion.load();
+
+    auto nyquist = fs * 0.5;
+    auto count = 0;
+
+    for (int t = 0; t < numRequested.load(); ++t)
+    {
+        auto requested = (double) requestedFrequencies[(size_t) t].load();
+
+        if (requested <= 0.0 || requested >= nyquist)
+            continue;
+
+        // A whole number of cycles in about windowSeconds, then the frequency that fits exactly
+        auto cycles = juce::jmax (1, juce::roundToInt (requested * windowSeconds));
+        auto length = juce::jlimit (1, historySize - 1, juce::roundToInt (cycles * fs / requested));
+        auto omega = juce::MathConstants<double>::twoPi * cycles / length;
+
+        auto& target = targets[(size_t) count];
+        target.length = length;
+        target.cosine = std::cos (omega);
+        target.sine = std::sin (omega);
+
+        // The history is already there, so fill the window from it rather than waiting
+        target.re = 0.0;
+        target.im = 0.0;
+
+        for (int n = length; n > 0; --n)
+        {
+            auto x = (double) history[(size_t) ((historyIndex - n) & (historySize - 1))];
+            auto re = target.re + x;
+            auto im = target.im;
+            target.re = re * target.cosine - im * target.sine;
+            target.im = re * target.sine + im * target.cosine;
+        }
+
+        trackedFrequencies[(size_t) count] = (float) (cycles * fs / length);
+        ++count;
+    }
+
+    numActive = count;
+}
+
+void ToneTracker::process (const float* samples, int numSamples)
+{
+    if (appliedVersion != requestedVersion.load())
+        applyTargets();
+
+    auto count = numActive.load();
+    constexpr int mask = historySize - 1;
+
+    for (int n = 0; n < numSamples; ++n)
+    {
+        auto x = samples[n];
+
+        // Add the new sample, drop the one leaving the window, rotate on by one sample
+        for (int t = 0; t < count; ++t)
+        {
+            auto& target = targets[(size_t) t];
+            auto delta = (double) x - (double) history[(size_t) ((historyIndex - target.length) & mask)];
+            auto re = target.re + delta;
+            auto im = target.im;
+            target.re = re * target.cosine - im * target.sine;
+            target.im = re * target.sine + im * target.cosine;
+        }
+
+        history[(size_t) historyIndex] = x;
+        historyIndex = (historyIndex + 1) & mask;
+
+        if (--samplesToNextPoint > 0)
+            continue;
+
+        samplesToNextPoint = samplesPerPoint;
+
+        // |S| / N reads a sine at half its amplitude, like the spectrum display
+        auto position = (size_t) (numPointsWritten.load (std::memory_order_relaxed) % traceLength);
+
+        for (int t = 0; t < count; ++t)
+        {
+            const auto& target = targets[(size_t) t];
+            auto magnitude = std::sqrt (target.re * target.re + target.im * target.im) / target.length;
+            traces[(size_t) t * traceLength + position] = magnitude > 0.0 ? (float) (20.0 * std::log10 (magnitude)) : floorDb;
+        }
+
+        numPointsWritten.fetch_add (1, std::memory_order_release);
+    }
+}
+
+int ToneTracker::readTrace (int target, float* levelsDb, int numPoints) const
+{
+    if (not juce::isPositiveAndBelow (target, numActive.load()))
+        return 0;
+
+    // Stay well clear of the point being written
+    auto written = numPointsWritten.load (std::memory_order_acquire);
+    auto available = (int) juce::jmin (written, (juce::int64) (traceLength - 256));
+    numPoints = juce::jmin (numPoints, available);
+
+    const auto* ring = traces.data() + (size_t) target * traceLength;
+
+    for (int n = 0; n < numPoints; ++n)
+        levelsDb[n] = ring[(written - numPoints + n) % traceLength];
+
+    return numPoints;
+}
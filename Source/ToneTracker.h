@@ -0,0 +1,94 @@
+/*
+==============================================================================
+
+    ToneTracker.h
+    Created: 19 Oct 2026 4:26:55am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Levels of a few chosen frequencies, updated on every input sample.
+
+    Each target runs a sliding DFT over the last windowSeconds of input. One
+    complex rotation per sample adds the newest sample and drops the one that
+    fell out of the window, so K targets cost O(K) per sample whatever the
+    window length. Each target's window is a whole number of its cycles, so
+    the frequency is nudged to the nearest one that fits. That also makes the
+    window null the target's own harmonics exactly, which is what you want
+    for mains hum.
+
+    The audio thread writes the levels into a ring of trace points at
+    traceRate per second, which the display reads without locking. Targets
+    are set from the message thread and picked up at the start of the next
+    block.
+*/
+
+class ToneTracker
+{
+public:
+    static constexpr int maxTargets = 8;
+    static constexpr double windowSeconds = 0.1;
+    static constexpr double traceRate = 1000.0; // Points per second
+    static constexpr int traceLength = 4096;    // Points kept per target
+
+    ToneTracker();
+
+    void prepare (double sampleRate);
+
+    // Message thread
+    void setTargets (const juce::Array<float>& frequencies);
+    juce::Array<float> getTargets() const;
+
+    // Audio thread
+    void process (const float* samples, int numSamples);
+
+    // Any thread. Targets as tracked, after fitting them to the window.
+    int getNumTargets() const { return numActive.load(); }
+    float getTrackedFrequency (int target) const { return trackedFrequencies[(size_t) target].load(); }
+
+    // Copies up to numPoints of the newest levels of a target, oldest first, in
+    // dB on the spectrum display's scale. Returns how many it copied.
+    int readTrace (int target, float* levelsDb, int numPoints) const;
+
+private:
+    void applyTargets();
+
+    static constexpr int historySize = 1 << 16; // Samples, enough for the window at 384 kHz
+    static constexpr float floorDb = -200.0f;
+
+    double fs = 44100.0;
+
+    // Requested targets, written on the message thread
+    std::array<std::atomic<float>, maxTargets> requestedFrequencies;
+    std::atomic<int> numRequested { 0 };
+    std::atomic<int> requestedVersion { 0 };
+    int appliedVersion = -1;
+
+    struct Target
+    {
+        int length = 1;               // Window length in samples
+        double cosine = 1.0, sine = 0.0;
+        double re = 0.0, im = 0.0;    // Running DFT
+    };
+
+    std::array<Target, maxTargets> targets;
+    std::array<std::atomic<float>, maxTargets> trackedFrequencies;
+    std::atomic<int> numActive { 0 };
+
+    std::vector<float> history;
+    int historyIndex = 0;
+
+    int samplesPerPoint = 44;
+    int samplesToNextPoint = 0;
+    std::vector<float> traces; // maxTargets rings of traceLength
+    std::atomic<juce::int64> numPointsWritten { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ToneTracker)
+};
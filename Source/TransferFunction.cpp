@@ -0,0 +1,164 @@
+/*
+==============================================================================
+
+    TransferFunction.cpp
+    Created: 19 Oct 2026 4:00:29am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "TransferFunction.h"
+
+//==============================================================================
+TransferFunction::TransferFunction (int fftOrder)
+    : fftSize (1 << fftOrder),
+      numBins (fftSize / 2),
+      fft (fftOrder),
+      window ((size_t) fftSize, juce::dsp::WindowingFunction<float>::hann)
+{
+    referenceSpectrum.resize ((size_t) (2 * fftSize), 0.0f);
+
+    sxx.resize ((size_t) numBins, 0.0f);
+    syy.resize ((size_t) numBins, 0.0f);
+    sxy.resize ((size_t) numBins, {});
+
+    magnitudeDb.resize ((size_t) numBins, 0.0f);
+    phase.resize ((size_t) numBins, 0.0f);
+    coherence.resize ((size_t) numBins, 0.0f);
+
+    delayLine.resize ((size_t) delaySearchSize, 0.0f);
+    referenceCapture.resize ((size_t) delaySearchSize, 0.0f);
+    measurementCapture.resize ((size_t) delaySearchSize, 0.0f);
+}
+
+void TransferFunction::prepare (double sampleRate)
+{
+    // Cross spectra need a fair few frames before the coherence means anything, so average over about a second
+    const auto averagingTime = 1.0;
+    averaging = static_cast<float> (std::exp (-fftSize / (averagingTime * sampleRate)));
+
+    reset();
+}
+
+void TransferFunction::reset()
+{
+    std::fill (sxx.begin(), sxx.end(), 0.0f);
+    std::fill (syy.begin(), syy.end(), 0.0f);
+    std::fill (sxy.begin(), sxy.end(), std::complex<float>());
+    std::fill (delayLine.begin(), delayLine.end(), 0.0f);
+    delayWriteIndex = 0;
+}
+
+float TransferFunction::pushSample (float reference, float measurement)
+{
+    if (delaySearchRequested.load() && not captureReady.load())
+    {
+        referenceCapture[(size_t) captureIndex] = reference;
+        measurementCapture[(size_t) captureIndex] = measurement;
+
+        if (++captureIndex == delaySearchSize)
+        {
+            captureIndex = 0;
+            delaySearchRequested = false;
+            captureReady = true;
+        }
+    }
+
+    const auto mask = delaySearchSize - 1;
+
+    delayLine[(size_t) delayWriteIndex] = reference;
+    auto delayed = delayLine[(size_t) ((delayWriteIndex - delaySamples.load()) & mask)];
+    delayWriteIndex = (delayWriteIndex + 1) & mask;
+
+    return delayed;
+}
+
+void TransferFunction::processFrame (const float* reference, const float* measurementSpectrum)
+{
+    auto* x = referenceSpectrum.data();
+    auto* y = measurementSpectrum;
+
+    juce::zeromem (x, sizeof (float) * referenceSpectrum.size());
+    memcpy (x, reference, sizeof (float) * (size_t) fftSize);
+
+    // Complex output, interleaved real and imaginary parts
+    window.multiplyWithWindowingTable (x, (size_t) fftSize);
+    fft.performRealOnlyForwardTransform (x, true);
+
+    const auto a = averaging;
+
+    for (int k = 0; k < numBins; ++k)
+    {
+        std::complex<float> X (x[2 * k], x[2 * k + 1]);
+        std::complex<float> Y (y[2 * k], y[2 * k + 1]);
+
+        sxx[(size_t) k] = a * sxx[(size_t) k] + (1 - a) * std::norm (X);
+        syy[(size_t) k] = a * syy[(size_t) k] + (1 - a) * std::norm (Y);
+        sxy[(size_t) k] = a * sxy[(size_t) k] + (1 - a) * std::conj (X) * Y;
+
+        // Bins without reference energy have no meaningful transfer function
+        const auto tiny = 1.0e-20f;
+        auto h = sxx[(size_t) k] > tiny ? sxy[(size_t) k] / sxx[(size_t) k] : std::complex<float>();
+        auto power = sxx[(size_t) k] * syy[(size_t) k];
+
+        magnitudeDb[(size_t) k] = juce::Decibels::gainToDecibels (std::abs (h));
+        phase[(size_t) k] = std::arg (h);
+        coherence[(size_t) k] = power > tiny ? juce::jlimit (0.0f, 1.0f, std::norm (sxy[(size_t) k]) / power) : 0.0f;
+    }
+}
+
+void TransferFunction::requestDelaySearch()
+{
+    captureReady = false;
+    delaySearchRequested = true;
+}
+
+void TransferFunction::updateDelaySearch()
+{
+    if (not captureReady.load())
+        return;
+
+    estimateDelay();
+    captureReady = false;
+}
+
+void TransferFunction::estimateDelay()
+{
+    // Zero-pad to twice the capture so the correlation doesn't wrap around
+    const int size = 2 * delaySearchSize;
+    juce::dsp::FFT correlationFFT (delaySearchOrder + 1);
+
+    std::vector<float> x ((size_t) (2 * size), 0.0f);
+    std::vector<float> y ((size_t) (2 * size), 0.0f);
+    std::copy (referenceCapture.begin(), referenceCapture.end(), x.begin());
+    std::copy (measurementCapture.begin(), measurementCapture.end(), y.begin());
+
+    correlationFFT.performRealOnlyForwardTransform (x.data(), true);
+    correlationFFT.performRealOnlyForwardTransform (y.data(), true);
+
+    // Cross spectrum conj(X) Y, whitened (PHAT) so the peak stays sharp for coloured signals
+    for (int k = 0; k <= size / 2; ++k)
+    {
+        std::complex<float> X (x[(size_t) (2 * k)], x[(size_t) (2 * k + 1)]);
+        std::complex<float> Y (y[(size_t) (2 * k)], y[(size_t) (2 * k + 1)]);
+
+        auto cross = std::conj (X) * Y;
+        auto magnitude = std::abs (cross);
+        cross = magnitude > 1.0e-12f ? cross / magnitude : std::complex<float>();
+
+        x[(size_t) (2 * k)] = cross.real();
+        x[(size_t) (2 * k + 1)] = cross.imag();
+    }
+
+    correlationFFT.performRealOnlyInverseTransform (x.data());
+
+    // Only positive lags, the measurement can't arrive before the reference
+    int bestLag = 0;
+
+    for (int lag = 1; lag < maxDelay; ++lag)
+        if (x[(size_t) lag] > x[(size_t) bestLag])
+            bestLag = lag;
+
+    delaySamples = bestLag;
+}
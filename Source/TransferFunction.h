@@ -0,0 +1,99 @@
+/*
+==============================================================================
+
+    TransferFunction.h
+    Created: 19 Oct 2026 4:00:29am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//==============================================================================
+/*
+    Dual-channel measurement between a reference signal (the sidechain) and the
+    measured signal (the main input). Each frame the reference is windowed and
+    run through a complex FFT, the measurement spectrum comes from the main
+    analysis, and the auto and cross spectra Sxx, Syy and Sxy are averaged. From those we get the transfer function H = Sxy / Sxx and the
+    magnitude-squared coherence |Sxy|^2 / (Sxx Syy).
+
+    The reference usually arrives earlier than the measurement, so it goes
+    through a delay line. The delay is found on request by capturing a stretch
+    of both signals and picking the peak of their cross-correlation, computed
+    with one zero-padded FFT per signal and PHAT weighting.
+*/
+
+class TransferFunction
+{
+public:
+    enum
+    {
+        delaySearchOrder = 15,
+        delaySearchSize  = 1 << delaySearchOrder, // 32768 samples captured per search
+        maxDelay = delaySearchSize / 2             // Longer lags leave too little overlap to trust
+    };
+
+    explicit TransferFunction (int fftOrder);
+
+    void prepare (double sampleRate);
+    void reset();
+
+    // Audio thread: runs the reference through the compensation delay and
+    // captures both signals while a delay search is pending
+    float pushSample (float reference, float measurement);
+
+    // Audio thread: one frame of fftSize reference samples, plus the complex
+    // spectrum of the measurement that the processor has already computed
+    void processFrame (const float* reference, const float* measurementSpectrum);
+
+    // Message thread: start a delay search, and finish it once the capture is full
+    void requestDelaySearch();
+    bool isDelaySearchPending() const { return delaySearchRequested.load() || captureReady.load(); }
+    void updateDelaySearch();
+
+    int getDelay() const { return delaySamples.load(); }
+
+    int getNumBins() const { return numBins; }
+    const float* getMagnitude() const { return magnitudeDb.data(); }
+    const float* getPhase() const { return phase.data(); }
+    const float* getCoherence() const { return coherence.data(); }
+
+private:
+    void estimateDelay();
+
+    const int fftSize;
+    const int numBins;
+
+    juce::dsp::FFT fft;
+    juce::dsp::WindowingFunction<float> window;
+
+    // Scratch for the complex transform, 2 * fftSize as dsp::FFT requires
+    std::vector<float> referenceSpectrum;
+
+    // Averaged auto and cross spectra
+    std::vector<float> sxx, syy;
+    std::vector<std::complex<float>> sxy;
+    float averaging = 0.0f;
+
+    // Published with each frame
+    std::vector<float> magnitudeDb;
+    std::vector<float> phase;
+    std::vector<float> coherence;
+
+    // Compensation delay on the reference
+    std::vector<float> delayLine;
+    int delayWriteIndex = 0;
+    std::atomic<int> delaySamples { 0 };
+
+    // Delay search capture, filled on the audio thread and read on the message thread
+    std::vector<float> referenceCapture;
+    std::vector<float> measurementCapture;
+    int captureIndex = 0;
+    std::atomic<bool> delaySearchRequested { false };
+    std::atomic<bool> captureReady { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TransferFunction)
+};
@@ -0,0 +1,458 @@
+#include "PluginProcessor.h"
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+
+// What the display shows for signals whose spectra are known exactly. Each
+// signal goes through processBlock like a host's audio would, and the checks
+// read the same smoothedFftData and spectralPeaks the Analyzer draws from, in
+// the same dB. The bounds are what the analysis does today with a little
+// margin, so an optimisation that changes what ends up on screen fails here
+// even when it's faster. The measured figures are printed next to the bounds,
+// like the benchmark and latency results.
+namespace
+{
+    using Window = AnalysisPipeline::Window;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr int fftSize = PluginProcessor::fftSize;
+    constexpr int numBins = fftSize / 2;
+
+    struct WindowBounds
+    {
+        Window window;
+        const char* name;
+        float scallopingDb;         // Most a tone between bins can read low in its loudest bin
+        float peakLevelDb;          // Most the peak label's level can be off, anywhere between bins
+        float peakFrequencyBins;    // Most the peak label's frequency can be off
+        int leakageBins;            // Further than this from a tone...
+        float leakageDb;            // ...everything is at least this far below it
+    };
+
+    const WindowBounds windows[] = {
+        { Window::hann,           "Hann",            1.45f, 0.4f,  0.02f, 8, -60.0f },
+        { Window::blackmanHarris, "Blackman-Harris", 0.85f, 0.05f, 0.01f, 4, -90.0f },
+        { Window::flatTop,        "Flat top",        0.02f, 0.45f, 0.2f,  4, -40.0f }
+    };
+
+    struct Display
+    {
+        std::vector<float> levelsDb;    // Per bin, relative to full scale like the Analyzer's
+        std::vector<float> floorDb;     // Per bin on the same scale, the noise floor when it's shown
+        PeakDetector::Result peaks;
+    };
+
+    // Plays signal into a fresh processor until numFrames frames have been
+    // published. The last frame is returned unsmoothed, or with infinite
+    // averaging the average of them all. Windows other than Hann are only
+    // used in the harmonics mode, so that's what they're measured in. The
+    // noise floor is tracked over the window choice given, if any.
+    template <typename Signal>
+    Display measure (Window window, SpectrumAverager::Mode averaging, int numFrames, Signal&& signal, int noiseFloorWindow = 0)
+    {
+        PluginProcessor processor;
+        processor.setParameterValue ("smoothTime", 0.0f);
+        processor.setParameterValue ("avgMode", (float) averaging);
+        processor.setParameterValue ("noiseFloor", (float) noiseFloorWindow);
+
+        if (window != Window::hann)
+        {
+            processor.setParameterValue ("displayMode", (float) PluginProcessor::DisplayMode::harmonics);
+            processor.setParameterValue ("flatTopWindow", window == Window::flatTop ? 1.0f : 0.0f);
+        }
+
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 position = 0;
+
+        for (int frame = 0; frame < numFrames;)
+        {
+            for (int n = 0; n < blockSize; ++n)
+            {
+                auto x = signal (position + n);
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    buffer.setSample (ch, n, x);
+            }
+
+            position += blockSize;
+            processor.processBlock (buffer, midi);
+
+            // Taken straight away, so none are dropped
+            if (processor.nextFFTBlockReady.get())
+            {
+                processor.nextFFTBlockReady.set (false);
+                ++frame;
+            }
+        }
+
+        Display display;
+        display.levelsDb.resize ((size_t) numBins);
+        display.floorDb.resize ((size_t) numBins);
+
+        auto referenceDb = juce::Decibels::gainToDecibels ((float) fftSize);
+
+        for (int k = 0; k < numBins; ++k)
+        {
+            display.levelsDb[(size_t) k] = juce::Decibels::gainToDecibels (processor.smoothedFftData[k], -300.0f) - referenceDb;
+            display.floorDb[(size_t) k] = juce::Decibels::gainToDecibels (processor.noiseFloorData[k], -300.0f) - referenceDb;
+        }
+
+        display.peaks = processor.spectralPeaks;
+        return display;
+    }
+
+    auto makeSine (double bin, float amplitude)
+    {
+        return [bin, amplitude] (juce::int64 n)
+        {
+            return amplitude * (float) std::sin (juce::MathConstants<double>::twoPi * bin * (double) n / fftSize + 0.3);
+        };
+    }
+
+    // A sine reads at half its amplitude on the display
+    float sineLevelDb (float amplitude)
+    {
+        return juce::Decibels::gainToDecibels (amplitude * 0.5f);
+    }
+
+    int loudestBin (const Display& display)
+    {
+        return (int) (std::max_element (display.levelsDb.begin(), display.levelsDb.end()) - display.levelsDb.begin());
+    }
+
+    // Loudest bin more than distance bins from the tone, relative to the tone's level
+    float leakageDb (const std::vector<float>& levelsDb, double bin, int distance, float toneDb)
+    {
+        auto loudest = -300.0f;
+
+        for (int k = 0; k < (int) levelsDb.size(); ++k)
+            if (std::abs ((double) k - bin) > distance)
+                loudest = juce::jmax (loudest, levelsDb[(size_t) k]);
+
+        return loudest - toneDb;
+    }
+
+    // Mean of the linear magnitudes of bins first to last, in dB
+    float meanLevelDb (const std::vector<float>& levelsDb, int first, int last)
+    {
+        double sum = 0.0;
+
+        for (int k = first; k <= last; ++k)
+            sum += std::pow (10.0, levelsDb[(size_t) k] / 20.0);
+
+        return (float) (20.0 * std::log10 (sum / (last - first + 1)));
+    }
+
+    // Window sum of squares over sum squared, times the size, in bins
+    double getEquivalentNoiseBandwidth (Window window)
+    {
+        const juce::dsp::WindowingFunction<float>::WindowingMethod methods[] = {
+            juce::dsp::WindowingFunction<float>::hann,
+            juce::dsp::WindowingFunction<float>::blackmanHarris,
+            juce::dsp::WindowingFunction<float>::flatTop
+        };
+
+        std::vector<float> table ((size_t) fftSize);
+        juce::dsp::WindowingFunction<float>::fillWindowingTables (table.data(), (size_t) fftSize, methods[(size_t) window], true);
+
+        double sum = 0.0, sumOfSquares = 0.0;
+
+        for (auto w : table)
+        {
+            sum += w;
+            sumOfSquares += (double) w * w;
+        }
+
+        return fftSize * sumOfSquares / (sum * sum);
+    }
+}
+
+TEST_CASE ("Sine at a bin centre", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    constexpr float amplitude = 0.5f;
+
+    for (const auto& bounds : windows)
+    {
+        for (auto bin : { 10, 200, 800 })
+        {
+            auto display = measure (bounds.window, SpectrumAverager::Mode::exponential, 2, makeSine (bin, amplitude));
+            auto levelError = display.levelsDb[(size_t) bin] - sineLevelDb (amplitude);
+            auto leakage = leakageDb (display.levelsDb, bin, bounds.leakageBins, sineLevelDb (amplitude));
+
+            std::cout << bounds.name << ", bin " << bin << ": level " << levelError << " dB, leakage " << leakage << " dB\n";
+
+            CHECK (loudestBin (display) == bin);
+            CHECK (std::abs (levelError) < 0.01f);
+            CHECK (leakage < bounds.leakageDb);
+
+            REQUIRE (display.peaks.numPeaks > 0);
+            CHECK (std::abs (display.peaks.peaks[0].frequency / (sampleRate / fftSize) - bin) < 0.01);
+            CHECK (std::abs (display.peaks.peaks[0].level - sineLevelDb (amplitude)) < 0.01f);
+        }
+    }
+}
+
+TEST_CASE ("Sine between bins", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    constexpr float amplitude = 0.5f;
+
+    for (const auto& bounds : windows)
+    {
+        for (auto bin : { 200.25, 200.5, 800.5 })
+        {
+            auto display = measure (bounds.window, SpectrumAverager::Mode::exponential, 2, makeSine (bin, amplitude));
+            auto expectedDb = sineLevelDb (amplitude);
+            auto loudestError = display.levelsDb[(size_t) loudestBin (display)] - expectedDb;
+            auto leakage = leakageDb (display.levelsDb, bin, bounds.leakageBins, expectedDb);
+
+            REQUIRE (display.peaks.numPeaks > 0);
+            const auto& peak = display.peaks.peaks[0];
+            auto frequencyError = peak.frequency / (sampleRate / fftSize) - bin;
+            auto peakLevelError = peak.level - expectedDb;
+
+            std::cout << bounds.name << ", bin " << bin << ": loudest bin " << loudestError << " dB, peak label "
+                      << peakLevelError << " dB / " << frequencyError << " bins, leakage " << leakage << " dB\n";
+
+            CHECK (std::abs ((double) loudestBin (display) - bin) <= 0.5);
+            CHECK (loudestError > -bounds.scallopingDb);
+            CHECK (loudestError < 0.02f);
+            CHECK (std::abs (peakLevelError) < bounds.peakLevelDb);
+            CHECK (std::abs (frequencyError) < bounds.peakFrequencyBins);
+            CHECK (leakage < bounds.leakageDb);
+        }
+    }
+}
+
+TEST_CASE ("Multitone", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+
+    const int bins[] = { 50, 173, 400, 777 };
+    const float amplitudes[] = { 0.3f, 0.1f, 0.03f, 0.01f };
+
+    auto signal = [&] (juce::int64 n)
+    {
+        auto x = 0.0f;
+
+        for (size_t t = 0; t < std::size (bins); ++t)
+            x += makeSine (bins[t], amplitudes[t]) (n);
+
+        return x;
+    };
+
+    for (const auto& bounds : windows)
+    {
+        auto display = measure (bounds.window, SpectrumAverager::Mode::exponential, 2, signal);
+
+        for (size_t t = 0; t < std::size (bins); ++t)
+        {
+            auto levelError = display.levelsDb[(size_t) bins[t]] - sineLevelDb (amplitudes[t]);
+            std::cout << bounds.name << ", tone at bin " << bins[t] << ": level " << levelError << " dB\n";
+            CHECK (std::abs (levelError) < 0.05f);
+        }
+
+        // The default three labels go to the three loudest tones, loudest first
+        REQUIRE (display.peaks.numPeaks == 3);
+
+        for (int p = 0; p < 3; ++p)
+            CHECK (std::abs (display.peaks.peaks[(size_t) p].frequency / (sampleRate / fftSize) - bins[p]) < 0.01);
+    }
+}
+
+TEST_CASE ("White noise floor", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    constexpr float amplitude = 0.1f;   // Uniform, so a variance of amplitude^2 / 3
+
+    for (const auto& bounds : windows)
+    {
+        juce::Random random (42);
+        auto display = measure (bounds.window, SpectrumAverager::Mode::infinite, 256,
+                                [&] (juce::int64) { return amplitude * (random.nextFloat() * 2.0f - 1.0f); });
+
+        // Averaged magnitudes of Gaussian bins come out at sqrt (pi / 4) of their RMS
+        auto variance = amplitude * amplitude / 3.0;
+        auto expectedDb = (float) (10.0 * std::log10 (variance * getEquivalentNoiseBandwidth (bounds.window) / fftSize)
+                                   + 10.0 * std::log10 (juce::MathConstants<double>::pi / 4.0));
+
+        auto floorError = meanLevelDb (display.levelsDb, 16, numBins - 16) - expectedDb;
+        auto tilt = meanLevelDb (display.levelsDb, 16, numBins / 2) - meanLevelDb (display.levelsDb, numBins / 2, numBins - 16);
+
+        std::cout << bounds.name << ", white noise: floor " << floorError << " dB, low minus high " << tilt << " dB\n";
+
+        CHECK (std::abs (floorError) < 0.25f);
+        CHECK (std::abs (tilt) < 0.25f);
+    }
+}
+
+TEST_CASE ("Pink noise slope", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+
+    for (const auto& bounds : windows)
+    {
+        // Paul Kellet's refined filter, within 0.05 dB of -3 dB/octave over the octaves measured
+        juce::Random random (42);
+        double b[7] = {};
+
+        auto pink = [&] (juce::int64)
+        {
+            auto white = random.nextDouble() * 2.0 - 1.0;
+            b[0] = 0.99886 * b[0] + white * 0.0555179;
+            b[1] = 0.99332 * b[1] + white * 0.0750759;
+            b[2] = 0.96900 * b[2] + white * 0.1538520;
+            b[3] = 0.86650 * b[3] + white * 0.3104856;
+            b[4] = 0.55000 * b[4] + white * 0.5329522;
+            b[5] = -0.7616 * b[5] - white * 0.0168980;
+            auto x = b[0] + b[1] + b[2] + b[3] + b[4] + b[5] + b[6] + white * 0.5362;
+            b[6] = white * 0.115926;
+            return (float) (0.02 * x);
+        };
+
+        auto display = measure (bounds.window, SpectrumAverager::Mode::infinite, 256, pink);
+
+        // Mean level per bin of each octave from 250 Hz to 16 kHz, which falls 3 dB per octave
+        auto binWidth = sampleRate / fftSize;
+        auto octaveDb = [&] (double lowFrequency)
+        {
+            return meanLevelDb (display.levelsDb, (int) std::ceil (lowFrequency / binWidth), (int) std::floor (2.0 * lowFrequency / binWidth));
+        };
+
+        auto slope = (octaveDb (8000.0) - octaveDb (250.0)) / 5.0f;
+
+        std::cout << bounds.name << ", pink noise: " << slope << " dB/octave\n";
+
+        CHECK (std::abs (slope + 3.0f) < 0.15f);
+    }
+}
+
+TEST_CASE ("Impulse", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+
+    for (const auto& bounds : windows)
+    {
+        // One in the middle of every frame, where the windows are at their widest
+        auto display = measure (bounds.window, SpectrumAverager::Mode::exponential, 2,
+                                [] (juce::int64 n) { return n % fftSize == fftSize / 2 ? 1.0f : 0.0f; });
+
+        auto [lowest, highest] = std::minmax_element (display.levelsDb.begin(), display.levelsDb.end());
+        std::cout << bounds.name << ", impulse: " << *highest - *lowest << " dB from flat\n";
+
+        CHECK (*highest - *lowest < 0.01f);
+    }
+}
+
+TEST_CASE ("DC", "[accuracy]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    constexpr float offset = 0.25f;
+
+    for (const auto& bounds : windows)
+    {
+        auto display = measure (bounds.window, SpectrumAverager::Mode::exponential, 2, [] (juce::int64) { return offset; });
+
+        // DC isn't split between positive and negative frequencies, so it reads at its full level
+        auto levelError = display.levelsDb[0] - juce::Decibels::gainToDecibels (offset);
+        auto leakage = leakageDb (display.levelsDb, 0.0, 5, juce::Decibels::gainToDecibels (offset));
+
+        std::cout << bounds.name << ", DC: level " << levelError << " dB, leakage " << leakage << " dB\n";
+
+        CHECK (std::abs (levelError) < 0.01f);
+        CHECK (leakage < -80.0f);
+    }
+}
+
+TEST_CASE ("Every pipeline size", "[accuracy]")
+{
+    // Every order the pipeline has been instantiated for, not just the
+    // processor's. Today that's only order 11, the same 2048 points as the
+    // tests above, so this adds nothing until more are: it's here so they're
+    // covered when they are.
+    int numSizes = 0;
+
+    for (int order = 8; order <= 16; ++order)
+    {
+        auto pipeline = AnalysisPipeline::create (order, 1);
+
+        if (pipeline == nullptr)
+            continue;
+
+        ++numSizes;
+        auto size = 1 << order;
+        std::vector<float> levelsDb ((size_t) size / 2);
+
+        for (const auto& bounds : windows)
+        {
+            for (auto bin : { size / 8.0, size / 8.0 + 0.5 })
+            {
+                std::vector<float> input ((size_t) size);
+
+                for (int n = 0; n < size; ++n)
+                    input[(size_t) n] = 0.5f * (float) std::sin (juce::MathConstants<double>::twoPi * bin * n / size + 0.3);
+
+                const float* channels[] = { input.data() };
+                pipeline->push (channels, 0, size);
+                pipeline->setWindow (bounds.window);
+                pipeline->transform();
+
+                const auto* magnitudes = pipeline->computeMagnitudes (nullptr);
+
+                for (int k = 0; k < size / 2; ++k)
+                    levelsDb[(size_t) k] = juce::Decibels::gainToDecibels (magnitudes[k] / (float) size, -300.0f);
+
+                auto loudest = *std::max_element (levelsDb.begin(), levelsDb.end()) - sineLevelDb (0.5f);
+                auto leakage = leakageDb (levelsDb, bin, bounds.leakageBins, sineLevelDb (0.5f));
+
+                std::cout << "Size " << size << ", " << bounds.name << ", bin " << bin << ": loudest bin "
+                          << loudest << " dB, leakage " << leakage << " dB\n";
+
+                CHECK (loudest > -bounds.scallopingDb);
+                CHECK (loudest < 0.02f);
+                CHECK (leakage < bounds.leakageDb);
+            }
+        }
+    }
+
+    std::cout << "Pipeline sizes covered: " << numSizes << "\n";
+    CHECK (numSizes > 0);
+}
+
+TEST_CASE ("Noise floor", "[noisefloor]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    constexpr float amplitude = 0.1f;   // Uniform noise, as in the white noise floor
+    constexpr double toneBin = 200.0;
+    constexpr int numFrames = 300;      // About 13 s, a few times the 5 s window
+
+    // A tone for a quarter of every two seconds, long enough gone for the floor under it to show
+    juce::Random random (42);
+    auto tone = makeSine (toneBin, 0.5f);
+    auto signal = [&] (juce::int64 n)
+    {
+        auto noise = amplitude * (random.nextFloat() * 2.0f - 1.0f);
+        return n % 96000 < 24000 ? noise + tone (n) : noise;
+    };
+
+    auto display = measure (Window::hann, SpectrumAverager::Mode::exponential, numFrames, signal, 2);
+
+    // Where the averaged spectrum of the noise alone would read
+    auto variance = amplitude * amplitude / 3.0;
+    auto expectedDb = (float) (10.0 * std::log10 (variance * getEquivalentNoiseBandwidth (Window::hann) / fftSize)
+                               + 10.0 * std::log10 (juce::MathConstants<double>::pi / 4.0));
+
+    auto floorError = meanLevelDb (display.floorDb, 16, numBins - 16) - expectedDb;
+    auto toneBinError = display.floorDb[(size_t) toneBin] - expectedDb;
+
+    std::cout << "Noise floor: " << floorError << " dB, under the tone " << toneBinError << " dB\n";
+
+    // The minimum of one bin is a noisy estimate, the mean of them all isn't.
+    // The tone is 44 dB over the noise, so under it only has to be near.
+    CHECK (std::abs (floorError) < 0.5f);
+    CHECK (std::abs (toneBinError) < 6.0f);
+}
@@ -38,3 +38,86 @@ TEST_CASE ("Boot performance")
         });
     };
 }
+
+TEST_CASE ("Analysis pipeline performance")
+{
+    constexpr int order = PluginProcessor::fftOrder;
+    constexpr int size = PluginProcessor::fftSize;
+
+    juce::Random random (42);
+    std::vector<float> left (size), right (size);
+
+    for (int n = 0; n < size; ++n)
+    {
+        left[(size_t) n] = random.nextFloat() * 2.0f - 1.0f;
+        right[(size_t) n] = random.nextFloat() * 2.0f - 1.0f;
+    }
+
+    const float* channels[] = { left.data(), right.data() };
+    std::vector<float> maxSmoothed (size / 2, 0.0f);
+    const auto maxLeak = 0.9f;
+
+    // What processBlock did per frame before the pipeline was specialised
+    BENCHMARK_ADVANCED ("Generic frame")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        juce::dsp::FFT forwardFFT (order);
+        juce::dsp::WindowingFunction<float> window (size, juce::dsp::WindowingFunction<float>::hann);
+        std::vector<float> fifo (size), rightFifo (size), fftData (2 * size);
+
+        meter.measure ([&] {
+            for (int n = 0; n < size; ++n)
+            {
+                rightFifo[(size_t) n] = right[(size_t) n];
+                fifo[(size_t) n] = left[(size_t) n];
+            }
+
+            juce::zeromem (fftData.data(), sizeof (float) * fftData.size());
+            memcpy (fftData.data(), fifo.data(), sizeof (float) * fifo.size());
+            window.multiplyWithWindowingTable (fftData.data(), size);
+            forwardFFT.performRealOnlyForwardTransform (fftData.data(), true);
+
+            for (int n = 0; n <= size / 2; n++)
+                fftData[(size_t) n] = std::hypot (fftData[2 * (size_t) n], fftData[2 * (size_t) n + 1]);
+
+            for (int n = 0; n < size / 2; n++)
+                maxSmoothed[(size_t) n] = maxLeak * maxSmoothed[(size_t) n] + (1 - maxLeak) * fftData[(size_t) n];
+
+            return fftData[1];
+        });
+    };
+
+    BENCHMARK_ADVANCED ("Specialised frame")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        auto pipeline = AnalysisPipeline::create (order, 2);
+        REQUIRE (pipeline != nullptr);
+        PeakHold peakHold (size / 2);
+
+        meter.measure ([&] {
+            pipeline->push (channels, 0, size);
+            pipeline->transform();
+            auto* magnitudes = pipeline->computeMagnitudes (nullptr);
+            peakHold.process (magnitudes);
+            return magnitudes[1];
+        });
+    };
+
+    BENCHMARK_ADVANCED ("Specialised frame, weighted")
+    (Catch::Benchmark::Chronometer meter)
+    {
+        auto pipeline = AnalysisPipeline::create (order, 2);
+        REQUIRE (pipeline != nullptr);
+
+        PeakHold peakHold (size / 2);
+        std::vector<float> gains ((size_t) size / 2, 0.5f);
+
+        meter.measure ([&] {
+            pipeline->push (channels, 0, size);
+            pipeline->transform();
+            auto* magnitudes = pipeline->computeMagnitudes (gains.data());
+            peakHold.process (magnitudes);
+            return magnitudes[1];
+        });
+    };
+}
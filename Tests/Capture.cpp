@@ -0,0 +1,122 @@
+#include "CaptureRecorder.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The capture recorder's writer against an audio thread that laps its ring.
+// A slow sample rate keeps the ring short: 35 s is 35000 samples.
+namespace
+{
+    constexpr double sampleRate = 1000.0;
+    constexpr int blockSize = 512;
+    constexpr int ringLength = 35000;
+    constexpr double seconds = 10.0;
+
+    // Every sample says where it came from, exactly, through a float WAV
+    float rampAt (juce::int64 sample)
+    {
+        return (float) sample / 65536.0f;
+    }
+
+    // Pushes numSamples of the ramp from sample on, in one go
+    void pushRamp (CaptureRecorder& recorder, juce::int64 sample, int numSamples)
+    {
+        juce::AudioBuffer<float> buffer (2, numSamples);
+
+        for (int n = 0; n < numSamples; ++n)
+            for (int c = 0; c < 2; ++c)
+                buffer.setSample (c, n, rampAt (sample + n));
+
+        recorder.push (buffer.getArrayOfReadPointers(), 2, numSamples);
+    }
+
+    bool waitFor (std::function<bool()> condition)
+    {
+        auto timeout = juce::Time::getMillisecondCounter() + 10000;
+
+        while (not condition())
+        {
+            if (juce::Time::getMillisecondCounter() > timeout)
+                return false;
+
+            juce::Thread::sleep (10);
+        }
+
+        return true;
+    }
+
+    std::unique_ptr<juce::AudioFormatReader> read (const juce::File& file)
+    {
+        juce::AudioFormatManager formats;
+        formats.registerBasicFormats();
+        return std::unique_ptr<juce::AudioFormatReader> (formats.createReaderFor (file));
+    }
+}
+
+TEST_CASE ("Capture ring overrun", "[capture]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    auto folder = juce::File::getSpecialLocation (juce::File::tempDirectory).getChildFile ("Capture test " + juce::String (juce::Random::getSystemRandom().nextInt()));
+
+    CaptureRecorder recorder;
+    recorder.setDirectory (folder);
+    recorder.setSeconds (seconds);
+    recorder.prepare (sampleRate, 2, blockSize);
+
+    SECTION ("A capture the ring has lapped before it's written starts later")
+    {
+        pushRamp (recorder, 0, 10000);
+        recorder.capture();
+
+        // The writer looks every 50 ms, so this is in well before it does. The
+        // first 5000 + blockSize samples of the capture are gone by then.
+        pushRamp (recorder, 10000, 30000);
+
+        REQUIRE (waitFor ([&] { return recorder.getLastFile() != juce::File(); }));
+        CHECK (recorder.getLastError().isEmpty());
+
+        auto expectedStart = 40000 + blockSize - ringLength;
+        auto reader = read (recorder.getLastFile());
+        REQUIRE (reader != nullptr);
+        CHECK (reader->lengthInSamples == 10000 - expectedStart);
+
+        juce::AudioBuffer<float> samples (2, (int) reader->lengthInSamples);
+        reader->read (&samples, 0, samples.getNumSamples(), 0, true, true);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            CHECK (samples.getSample (c, 0) == rampAt (expectedStart));
+            CHECK (samples.getSample (c, samples.getNumSamples() - 1) == rampAt (9999));
+        }
+    }
+
+    SECTION ("A capture lapped while it's being written is cut short")
+    {
+        recorder.setTrigger (CaptureRecorder::Trigger::level);
+        recorder.setThresholdDb (-6.0f);
+
+        pushRamp (recorder, 0, 10000);
+
+        // Fires at sample 10000, so the capture ends 5000 samples from now
+        // and the writer sits waiting for them
+        juce::AudioBuffer<float> hit (2, blockSize);
+        hit.clear();
+        hit.setSample (0, 0, 1.0f);
+        hit.setSample (1, 0, 1.0f);
+        recorder.push (hit.getArrayOfReadPointers(), 2, blockSize);
+
+        REQUIRE (waitFor ([&] { return recorder.isWriting(); }));
+        juce::Thread::sleep (200);
+
+        // Laps the ring in one go while it sleeps
+        pushRamp (recorder, 10000 + blockSize, ringLength + 5000);
+
+        REQUIRE (waitFor ([&] { return recorder.getLastFile() != juce::File(); }));
+        CHECK (recorder.getLastError() == "The disk fell behind, the capture was cut short");
+
+        auto reader = read (recorder.getLastFile());
+        REQUIRE (reader != nullptr);
+        CHECK (reader->lengthInSamples < (juce::int64) (seconds * sampleRate));
+    }
+
+    recorder.release();
+    folder.deleteRecursively();
+}
@@ -0,0 +1,76 @@
+#include "PluginProcessor.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The harmonics mode through processBlock, against a tone whose distortion is
+// known exactly: THD is the harmonics' RMS over the fundamental's
+namespace
+{
+    using Window = AnalysisPipeline::Window;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    constexpr double fundamental = 1000.0;
+    constexpr float amplitude = 0.5f;
+    constexpr float secondRatio = 0.01f;    // -40 dB
+    constexpr float thirdRatio = 0.00316f;  // -50 dB
+
+    HarmonicAnalyzer::Result play (Window window, int numFrames)
+    {
+        PluginProcessor processor;
+        processor.setParameterValue ("displayMode", (float) PluginProcessor::DisplayMode::harmonics);
+        processor.setParameterValue ("flatTopWindow", window == Window::flatTop ? 1.0f : 0.0f);
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        juce::int64 position = 0;
+
+        for (int frame = 0; frame < numFrames;)
+        {
+            for (int n = 0; n < blockSize; ++n)
+            {
+                auto phase = juce::MathConstants<double>::twoPi * fundamental * (double) (position + n) / sampleRate;
+                auto x = amplitude * (float) (std::sin (phase)
+                                              + secondRatio * std::sin (2.0 * phase + 0.4)
+                                              + thirdRatio * std::sin (3.0 * phase + 1.1));
+
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    buffer.setSample (ch, n, x);
+            }
+
+            position += blockSize;
+            processor.processBlock (buffer, midi);
+
+            if (processor.nextFFTBlockReady.get())
+            {
+                processor.nextFFTBlockReady.set (false);
+                ++frame;
+            }
+        }
+
+        return processor.harmonicReadings;
+    }
+}
+
+TEST_CASE ("Harmonic distortion", "[harmonics]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    auto expectedThd = 100.0f * std::sqrt (secondRatio * secondRatio + thirdRatio * thirdRatio);
+
+    for (auto window : { Window::blackmanHarris, Window::flatTop })
+    {
+        DYNAMIC_SECTION ((window == Window::flatTop ? "Flat top" : "Blackman-Harris"))
+        {
+            // Enough for the averaging to fill
+            auto result = play (window, 16);
+
+            REQUIRE (result.isValid);
+            REQUIRE (result.numHarmonics >= 3);
+            CHECK (std::abs (result.harmonics[0].frequency - (float) fundamental) < 1.0f);
+            CHECK (std::abs (result.harmonics[1].level - result.harmonics[0].level + 40.0f) < 0.1f);
+            CHECK (std::abs (result.harmonics[2].level - result.harmonics[0].level + 50.0f) < 0.1f);
+            CHECK (std::abs (result.thd - expectedThd) < 0.01f * expectedThd);
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#include "PluginProcessor.h"
+#include "Analyzer.h"
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+
+// How long a tone burst takes from the input of processBlock to the pixels of
+// the analyzer, with the audio and the 30 Hz editor timer driven by hand on a
+// simulated clock. Only the paint is timed for real.
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 64;           // Small, so block granularity doesn't hide much
+    constexpr double uiRate = 30.0;         // Same as the Analyzer's timer
+    constexpr float toneFrequency = 1000.0f;
+    constexpr int burstLength = 4800;       // 100 ms
+    constexpr int maxSamples = (int) sampleRate * 3;
+
+    struct Latency
+    {
+        int fifoFill = 0;       // Onset until the frame showing it is complete
+        int frameWait = 0;      // Complete until it's published, at the end of the block it completed in
+        int skippedFrames = 0;  // Frames in the meantime the editor missed, still holding the one before
+        int handoff = 0;        // Published until the next timer tick picks it up
+        double paintMs = 0.0;   // Copying the frame and rendering it
+
+        int getSamples() const  { return fifoFill + frameWait + handoff; }
+        double getMs() const    { return getSamples() * 1000.0 / sampleRate + paintMs; }
+    };
+
+    // Pixels around the tone's column that differ from the picture before the burst
+    int countChangedPixels (const juce::Image& before, const juce::Image& after, int x)
+    {
+        int changed = 0;
+
+        for (int px = juce::jmax (0, x - 3); px <= juce::jmin (before.getWidth() - 1, x + 3); ++px)
+            for (int py = 0; py < before.getHeight(); ++py)
+                if (before.getPixelAt (px, py) != after.getPixelAt (px, py))
+                    ++changed;
+
+        return changed;
+    }
+
+    Latency measure (int onset)
+    {
+        PluginProcessor processor;
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        Analyzer scope (processor, sampleRate);
+        scope.setSize (500, 300);
+        scope.stopTimer(); // We tick it ourselves
+
+        // Same width drawFrame uses, less the level meter strip
+        auto toneX = juce::roundToInt (scope.frequencyToX (toneFrequency, (float) scope.getWidth() - 56.0f));
+
+        juce::AudioBuffer<float> buffer (processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        auto samplesPerTick = sampleRate / uiRate;
+        auto nextTick = samplesPerTick;
+
+        auto baseline = scope.createComponentSnapshot (scope.getLocalBounds());
+        std::optional<int> published;
+        juce::int64 completed = 0;
+        juce::uint64 skippedAtOnset = 0, skippedAtPublish = 0;
+
+        for (int start = 0; start < maxSamples; start += blockSize)
+        {
+            // Silence, then the burst
+            buffer.clear();
+
+            for (int n = 0; n < blockSize; ++n)
+            {
+                auto t = start + n - onset;
+
+                if (t >= 0 && t < burstLength)
+                    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                        buffer.setSample (ch, n, 0.5f * std::sin (juce::MathConstants<float>::twoPi * toneFrequency * (float) t / (float) sampleRate));
+            }
+
+            if (start <= onset && onset < start + blockSize)
+                skippedAtOnset = processor.getPerformanceCounters().getNumDroppedFrames();
+
+            auto wasReady = processor.nextFFTBlockReady.get();
+            processor.processBlock (buffer, midi);
+            auto end = start + blockSize;
+
+            // Only frames from after the onset can show the burst
+            if (not wasReady && processor.nextFFTBlockReady.get() && end > onset)
+            {
+                // Every frame publishes the input sample just after it with its onsets
+                published = end;
+                completed = processor.onsets.frameEnd;
+                skippedAtPublish = processor.getPerformanceCounters().getNumDroppedFrames();
+            }
+
+            if (end < nextTick)
+                continue;
+
+            nextTick += samplesPerTick;
+
+            if (not processor.nextFFTBlockReady.get())
+                continue;
+
+            auto paintStart = juce::Time::getMillisecondCounterHiRes();
+            scope.timerCallback();
+            auto image = scope.createComponentSnapshot (scope.getLocalBounds());
+            auto paintMs = juce::Time::getMillisecondCounterHiRes() - paintStart;
+
+            if (published.has_value() && countChangedPixels (baseline, image, toneX) > 0)
+            {
+                Latency latency;
+                latency.skippedFrames = (int) (skippedAtPublish - skippedAtOnset);
+                latency.fifoFill = (int) (completed - onset);
+                latency.frameWait = (int) (*published - completed);
+                latency.handoff = end - *published;
+                latency.paintMs = paintMs;
+                return latency;
+            }
+
+            // Not visible yet (the first frame may hold only the faded edge of the window)
+            published.reset();
+        }
+
+        FAIL ("The burst never showed up");
+        return {};
+    }
+}
+
+TEST_CASE ("Sample to pixel latency", "[latency]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+
+    // A few onsets, so the burst lands at different points of the FFT frame and the timer period
+    for (auto onset : { 48000, 48000 + 700, 48000 + 1500, 48000 + 2900 })
+    {
+        auto latency = measure (onset);
+
+        std::cout << "Onset " << onset
+                  << ": FIFO fill " << latency.fifoFill
+                  << " samples (" << latency.skippedFrames << " frames skipped)"
+                  << ", frame wait " << latency.frameWait
+                  << ", handoff " << latency.handoff
+                  << " samples, paint " << latency.paintMs << " ms"
+                  << ", total " << latency.getSamples() << " samples / " << latency.getMs() << " ms\n";
+
+        CHECK (latency.fifoFill >= 0);
+        CHECK (latency.handoff >= 0);
+
+        // The frame is analysed and published in the block that completes it
+        CHECK (latency.frameWait >= 0);
+        CHECK (latency.frameWait < blockSize);
+
+        // The ticks come more often than frames, so the editor never misses one
+        CHECK (latency.skippedFrames == 0);
+
+        // One frame of fill, a frame that misses the burst and one tick of handoff, with a tick to spare
+        auto worstCaseSamples = 2 * PluginProcessor::fftSize + 2 * (int) std::ceil (sampleRate / uiRate) + blockSize;
+        CHECK (latency.getSamples() <= worstCaseSamples);
+    }
+}
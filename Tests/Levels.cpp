@@ -0,0 +1,85 @@
+#include "PluginProcessor.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The level meter's loudness and true peak against the test signals of EBU
+// Tech 3341, played through processBlock and read from the published readings
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+
+    // Plays a stereo signal into a fresh processor for some seconds and
+    // returns the readings published with the last frame
+    template <typename Signal>
+    LevelMeter::Readings play (double seconds, Signal&& signal)
+    {
+        PluginProcessor processor;
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        LevelMeter::Readings readings;
+
+        for (juce::int64 position = 0; position < (juce::int64) (seconds * sampleRate); position += blockSize)
+        {
+            buffer.clear();
+
+            for (int n = 0; n < blockSize; ++n)
+                for (int ch = 0; ch < juce::jmin (2, buffer.getNumChannels()); ++ch)
+                    buffer.setSample (ch, n, signal (position + n));
+
+            processor.processBlock (buffer, midi);
+
+            if (processor.nextFFTBlockReady.get())
+            {
+                readings = processor.levelReadings;
+                processor.nextFFTBlockReady.set (false);
+            }
+        }
+
+        return readings;
+    }
+
+    auto makeSine (double frequency, float levelDb, double phase = 0.0)
+    {
+        auto amplitude = juce::Decibels::decibelsToGain (levelDb);
+
+        return [frequency, amplitude, phase] (juce::int64 n)
+        {
+            return amplitude * (float) std::sin (juce::MathConstants<double>::twoPi * frequency * (double) n / sampleRate + phase);
+        };
+    }
+}
+
+TEST_CASE ("Level meter", "[levels]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    // Tech 3341 cases 1 and 2: a 1 kHz stereo sine reads its peak level in
+    // dBFS as LUFS, within 0.1 LU, momentary and short-term. So -20 dBFS would
+    // read -20 LUFS, the spec's -23 LUFS is the sine at -23 dBFS.
+    for (auto levelDb : { -23.0f, -33.0f })
+    {
+        DYNAMIC_SECTION ("Loudness of a 1 kHz sine at " << levelDb << " dBFS")
+        {
+            auto readings = play (4.0, makeSine (1000.0, levelDb));
+
+            CHECK (std::abs (readings.momentary - levelDb) < 0.1f);
+            CHECK (std::abs (readings.shortTerm - levelDb) < 0.1f);
+            CHECK (std::abs (readings.rms - (levelDb - 3.01f)) < 0.05f);
+            CHECK (std::abs (readings.peak - levelDb) < 0.01f);
+        }
+    }
+
+    // A quarter of the sample rate at 45 degrees never has a sample on its
+    // peaks, so the sample peak is 3 dB short of them. Tech 3341 allows the
+    // true peak +0.2 / -0.4 dB.
+    SECTION ("True peak between the samples")
+    {
+        constexpr float levelDb = -6.0f;
+        auto readings = play (1.0, makeSine (sampleRate / 4.0, levelDb, juce::MathConstants<double>::pi / 4.0));
+
+        CHECK (std::abs (readings.peak - (levelDb - 3.01f)) < 0.01f);
+        CHECK (readings.truePeak > levelDb - 0.4f);
+        CHECK (readings.truePeak < levelDb + 0.2f);
+    }
+}
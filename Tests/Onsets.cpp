@@ -0,0 +1,78 @@
+#include "PluginProcessor.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The onset detector through processBlock: a click in silence is one onset,
+// placed on the click's sample, and silence is none
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 64; // Well under a frame, so none are dropped
+    constexpr int fftSize = PluginProcessor::fftSize;
+
+    // Plays silence with a click at clickSample, if any, and returns every
+    // frame's onset result
+    std::vector<OnsetDetector::Result> play (int numSamples, juce::int64 clickSample)
+    {
+        PluginProcessor processor;
+        processor.prepareToPlay (sampleRate, blockSize);
+
+        juce::AudioBuffer<float> buffer (processor.getTotalNumInputChannels(), blockSize);
+        juce::MidiBuffer midi;
+        std::vector<OnsetDetector::Result> frames;
+
+        for (juce::int64 position = 0; position < numSamples; position += blockSize)
+        {
+            buffer.clear();
+
+            if (clickSample >= position && clickSample < position + blockSize)
+                for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                    buffer.setSample (ch, (int) (clickSample - position), 0.5f);
+
+            processor.processBlock (buffer, midi);
+
+            if (processor.nextFFTBlockReady.get())
+            {
+                frames.push_back (processor.onsets);
+                processor.nextFFTBlockReady.set (false);
+            }
+        }
+
+        return frames;
+    }
+}
+
+TEST_CASE ("Onsets", "[onsets]")
+{
+    auto gui = juce::ScopedJuceInitialiser_GUI {};
+    SECTION ("A click in silence")
+    {
+        // Part way into the fourth frame
+        constexpr juce::int64 clickSample = 3 * fftSize + 700;
+        auto frames = play (8 * fftSize, clickSample);
+        REQUIRE (frames.size() == 8);
+
+        int numOnsets = 0;
+
+        for (const auto& frame : frames)
+        {
+            if (not frame.isOnset)
+                continue;
+
+            ++numOnsets;
+            CHECK (frame.frameEnd == 4 * fftSize);
+            CHECK (std::abs (frame.onsetSample - clickSample) < 32); // The detector's energy block
+            CHECK (frame.strength > 1.0f);
+        }
+
+        CHECK (numOnsets == 1);
+    }
+
+    SECTION ("Silence")
+    {
+        for (const auto& frame : play (8 * fftSize, -1))
+        {
+            CHECK (not frame.isOnset);
+            CHECK (frame.flux == 0.0f);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include "PeakHold.h"
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+
+// The peak hold fed frames directly, at the rate the processor's FIFO makes them
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int fftSize = 2048;
+    constexpr int numBins = fftSize / 2;
+}
+
+TEST_CASE ("Peak hold", "[peakhold]")
+{
+    constexpr float holdSeconds = 1.0f;
+    constexpr float fallRate = 20.0f;
+    constexpr double framesPerSecond = sampleRate / fftSize;
+
+    PeakHold peakHold (numBins);
+    peakHold.prepare (sampleRate, fftSize);
+    peakHold.setHoldSeconds (holdSeconds);
+    peakHold.setFallRate (fallRate);
+
+    std::vector<float> peak ((size_t) numBins, 1.0f), silence ((size_t) numBins, 0.0f);
+
+    // Seconds since the peak after this many more frames of silence
+    auto seconds = 0.0;
+    auto playSilence = [&] (double untilSeconds)
+    {
+        for (; seconds + 1.0 / framesPerSecond <= untilSeconds; seconds += 1.0 / framesPerSecond)
+            peakHold.process (silence.data());
+    };
+
+    auto heldDb = [&] { return juce::Decibels::gainToDecibels (peakHold.getLevels()[10], -300.0f); };
+
+    SECTION ("Holds, then falls at the rate")
+    {
+        peakHold.process (peak.data());
+
+        playSilence (holdSeconds);
+        CHECK (heldDb() == 0.0f);
+
+        playSilence (holdSeconds + 1.0);
+        auto fallen = heldDb();
+        std::cout << "Peak hold: " << fallen << " dB a second after the hold\n";
+
+        // Give or take the frames the hold and the fall started on
+        auto perFrameDb = fallRate / (float) framesPerSecond;
+        CHECK (fallen < -fallRate + perFrameDb * 2.0f);
+        CHECK (fallen > -fallRate - perFrameDb * 2.0f);
+    }
+
+    SECTION ("Infinite hold never falls, until reset")
+    {
+        peakHold.setInfinite (true);
+        peakHold.process (peak.data());
+
+        playSilence (10.0);
+        CHECK (heldDb() == 0.0f);
+
+        peakHold.reset();
+        peakHold.process (silence.data());
+        CHECK (peakHold.getLevels()[10] == 0.0f);
+    }
+}
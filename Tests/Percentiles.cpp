@@ -0,0 +1,82 @@
+#include "SpectrumPercentiles.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The percentile histograms fed frames of known levels directly
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int fftSize = 2048;
+    constexpr int numBins = fftSize / 2;
+}
+
+TEST_CASE ("Percentile histograms", "[percentiles]")
+{
+    SpectrumPercentiles percentiles (numBins, fftSize);
+    percentiles.prepare (sampleRate);
+
+    SpectrumPercentiles::Result result;
+    std::vector<float> frame ((size_t) numBins);
+
+    // Every bin at this level, on the display's scale of magnitude / fftSize
+    auto play = [&] (float levelDb)
+    {
+        std::fill (frame.begin(), frame.end(), (float) fftSize * juce::Decibels::decibelsToGain (levelDb, -1000.0f));
+        percentiles.processFrame (frame.data(), result);
+    };
+
+    // A multiple of the frames between updates at 48 kHz, so the result is fresh at the end
+    constexpr int numFrames = 600;
+
+    SECTION ("A known spread of levels over the session")
+    {
+        // 100 levels a dB apart, each in the middle of its bucket, played in turn.
+        // A tenth of the frames are above -11 dB, half above -51 and nine tenths above -91.
+        percentiles.setWindowSeconds (0.0);
+
+        for (int n = 0; n < numFrames; ++n)
+            play (-100.5f + (float) (n % 100));
+
+        REQUIRE (result.numColumns == numBins);
+        CHECK (std::abs (result.seconds - numFrames * fftSize / sampleRate) < 1.0e-6);
+
+        for (int column : { 0, 100, numBins - 1 })
+        {
+            CHECK (std::abs (result.levelsDb[0][(size_t) column] + 11.0f) < 0.01f);
+            CHECK (std::abs (result.levelsDb[1][(size_t) column] + 51.0f) < 0.01f);
+            CHECK (std::abs (result.levelsDb[2][(size_t) column] + 91.0f) < 0.01f);
+        }
+    }
+
+    SECTION ("Loud frames older than the window age out")
+    {
+        percentiles.setWindowSeconds (10.0);
+
+        for (int n = 0; n < numFrames / 2; ++n)
+            play (-20.5f);
+
+        // Nearly 13 s of quiet, longer than the window
+        for (int n = 0; n < numFrames / 2; ++n)
+            play (-80.5f);
+
+        REQUIRE (result.numColumns == numBins);
+        CHECK (result.seconds <= 10.0);
+        CHECK (result.seconds >= 10.0 * (SpectrumPercentiles::numSegments - 1) / SpectrumPercentiles::numSegments);
+
+        for (const auto& levels : result.levelsDb)
+        {
+            CHECK (levels[10] > -81.0f);
+            CHECK (levels[10] < -80.0f);
+        }
+    }
+
+    SECTION ("Reset starts over")
+    {
+        for (int n = 0; n < numFrames; ++n)
+            play (-20.5f);
+
+        percentiles.reset();
+        play (-80.5f);
+
+        CHECK (result.numColumns == 0);
+    }
+}
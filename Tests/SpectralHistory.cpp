@@ -0,0 +1,117 @@
+#include "SpectralHistory.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The spectral history's encoding: what goes in comes back out to within the
+// precision's step, however the frames were stored and evicted
+namespace
+{
+    constexpr int numBins = 1024;
+}
+
+TEST_CASE ("Spectral history encoding", "[history]")
+{
+    constexpr double framesPerSecond = 10.0;
+    juce::Random random (42);
+
+    // A slow random walk per bin that the deltas can follow, with a jump every
+    // so often that they can't. Kept inside the range either precision stores.
+    std::vector<std::vector<float>> played;
+    std::vector<float> levels ((size_t) numBins, -60.0f);
+
+    auto play = [&] (SpectralHistory& history)
+    {
+        auto jump = played.size() % 45 == 44 ? 30.0f : 0.0f;
+
+        for (auto& level : levels)
+            level = juce::jlimit (-115.0f, -5.0f, level + jump + 2.0f * random.nextFloat() - 1.0f);
+
+        history.push (levels.data(), (double) played.size() * 1000.0 / framesPerSecond);
+        played.push_back (levels);
+    };
+
+    // Every kept frame decodes to what was played, to within half a step, and
+    // the kept frames are the newest ones, in order
+    auto checkNewest = [&] (const SpectralHistory& history, float stepDb)
+    {
+        std::vector<float> decoded ((size_t) numBins);
+        auto firstPlayed = (int) played.size() - history.getNumFrames();
+
+        for (int index = 0; index < history.getNumFrames(); ++index)
+        {
+            const auto& original = played[(size_t) (firstPlayed + index)];
+            history.decode (index, decoded.data());
+
+            auto worstDb = 0.0f;
+
+            for (int n = 0; n < numBins; ++n)
+                worstDb = juce::jmax (worstDb, std::abs (decoded[(size_t) n] - original[(size_t) n]));
+
+            CHECK (worstDb <= 0.5f * stepDb + 1.0e-4f);
+            CHECK (history.getFrameTime (index) == (double) (firstPlayed + index) * 1000.0 / framesPerSecond);
+        }
+    };
+
+    const struct
+    {
+        SpectralHistory::Precision precision;
+        const char* name;
+        float stepDb;
+    } precisions[] = {
+        { SpectralHistory::Precision::eightBit,  "8 bit",  0.5f },
+        { SpectralHistory::Precision::twelveBit, "12 bit", 1.0f / 32.0f }
+    };
+
+    for (const auto& p : precisions)
+    {
+        for (auto useDeltas : { false, true })
+        {
+            DYNAMIC_SECTION (p.name << (useDeltas ? " with deltas" : " keyframes only"))
+            {
+                // Room for 20 keyframes
+                SpectralHistory history (numBins, 2.0, framesPerSecond, p.precision, useDeltas);
+                played.clear();
+
+                SECTION ("Round trip before anything is evicted")
+                {
+                    // Keyframes alone fill the bytes at 20 frames, deltas take
+                    // two thirds of that or less
+                    for (int f = 0; f < 25; ++f)
+                        play (history);
+
+                    REQUIRE (history.getNumFrames() == (useDeltas ? 25 : 20));
+                    checkNewest (history, p.stepDb);
+                }
+
+                SECTION ("The oldest frames are evicted, and decoding still starts at a keyframe")
+                {
+                    // Past several keyframes, forced ones included. Evicting a
+                    // keyframe takes its deltas along, so how many frames are
+                    // kept goes up and down; what's kept must still decode.
+                    for (int f = 0; f < 200; ++f)
+                    {
+                        play (history);
+
+                        REQUIRE (history.getNumFrames() >= 1);
+                        REQUIRE (history.getNumFrames() <= (useDeltas ? 40 : 20));
+                        checkNewest (history, p.stepDb);
+                    }
+                }
+
+                SECTION ("Clear starts over")
+                {
+                    for (int f = 0; f < 50; ++f)
+                        play (history);
+
+                    history.clear();
+                    CHECK (history.getNumFrames() == 0);
+
+                    played.clear();
+                    play (history);
+
+                    REQUIRE (history.getNumFrames() == 1);
+                    checkNewest (history, p.stepDb);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include "PluginProcessor.h"
+#include <catch2/catch_test_macros.hpp>
+#include <iostream>
+
+// The reassigned spectrogram on a single frame of a tone and of clicks, run
+// through the processor's pipeline the way processFrame does
+namespace
+{
+    using Window = AnalysisPipeline::Window;
+
+    constexpr double sampleRate = 48000.0;
+    constexpr int fftSize = PluginProcessor::fftSize;
+
+    auto makeSine (double bin, float amplitude)
+    {
+        return [bin, amplitude] (juce::int64 n)
+        {
+            return amplitude * (float) std::sin (juce::MathConstants<double>::twoPi * bin * (double) n / fftSize + 0.3);
+        };
+    }
+
+    // A sine reads at half its amplitude on the display
+    float sineLevelDb (float amplitude)
+    {
+        return juce::Decibels::gainToDecibels (amplitude * 0.5f);
+    }
+}
+
+TEST_CASE ("Reassigned spectrogram", "[spectrogram]")
+{
+    auto pipeline = AnalysisPipeline::create (PluginProcessor::fftOrder, 1);
+    REQUIRE (pipeline != nullptr);
+
+    ReassignedSpectrogram spectrogram (PluginProcessor::fftOrder);
+    spectrogram.prepare (sampleRate);
+
+    auto result = std::make_unique<ReassignedSpectrogram::Result>();
+    std::vector<float> input ((size_t) fftSize);
+
+    auto analyse = [&]
+    {
+        const float* channels[] = { input.data() };
+        pipeline->push (channels, 0, fftSize);
+        pipeline->setWindow (Window::hann);
+        pipeline->transform();
+        spectrogram.transform (pipeline->getFifo (0));
+        spectrogram.reassign (pipeline->getSpectrum(), *result);
+    };
+
+    auto cellOf = [] (double frequency)
+    {
+        return (int) (std::log (frequency / ReassignedSpectrogram::minFrequency) * ReassignedSpectrogram::numCells
+                      / std::log (0.5 * sampleRate / ReassignedSpectrogram::minFrequency));
+    };
+
+    SECTION ("A tone between bins gathers into its own cell at its full level")
+    {
+        constexpr double bin = 200.5;
+
+        for (int n = 0; n < fftSize; ++n)
+            input[(size_t) n] = makeSine (bin, 0.5f) (n);
+
+        analyse();
+
+        auto loudest = ReassignedSpectrogram::minDb;
+        auto loudestCell = 0;
+
+        for (const auto& slice : result->levelsDb)
+            for (int cell = 0; cell < ReassignedSpectrogram::numCells; ++cell)
+                if (slice[(size_t) cell] > loudest)
+                {
+                    loudest = slice[(size_t) cell];
+                    loudestCell = cell;
+                }
+
+        auto levelError = loudest - sineLevelDb (0.5f);
+        std::cout << "Reassigned tone: level " << levelError << " dB, cell " << loudestCell
+                  << " for " << cellOf (bin * sampleRate / fftSize) << "\n";
+
+        // Without reassignment the loudest bin would read the Hann scalloping low
+        CHECK (std::abs (levelError) < 0.1f);
+        CHECK (std::abs (loudestCell - cellOf (bin * sampleRate / fftSize)) <= 1);
+    }
+
+    SECTION ("A click lands in the slice it happened in")
+    {
+        for (auto position : { fftSize / 16, fftSize / 2 + fftSize / 16, fftSize - fftSize / 16 })
+        {
+            std::fill (input.begin(), input.end(), 0.0f);
+            input[(size_t) position] = 1.0f;
+            analyse();
+
+            auto expectedSlice = position * ReassignedSpectrogram::slicesPerFrame / fftSize;
+
+            for (int slice = 0; slice < ReassignedSpectrogram::slicesPerFrame; ++slice)
+            {
+                const auto& levelsDb = result->levelsDb[(size_t) slice];
+                auto numFilled = std::count_if (levelsDb.begin(), levelsDb.end(),
+                                                [] (float level) { return level > ReassignedSpectrogram::minDb; });
+
+                if (slice == expectedSlice)
+                    CHECK (numFilled > 0);
+                else
+                    CHECK (numFilled == 0);
+            }
+        }
+    }
+}
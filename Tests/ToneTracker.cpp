@@ -0,0 +1,65 @@
+#include "ToneTracker.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The tone tracker on mains hum: the level of the 50 Hz target, on the
+// spectrum display's scale where a sine reads 6 dB under its amplitude, and
+// the frequencies it settles on
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int blockSize = 512;
+    constexpr float amplitude = 0.5f;
+
+    // A second of 50 Hz with its third harmonic at the same level, which the
+    // 50 Hz window nulls
+    void play (ToneTracker& tracker)
+    {
+        std::vector<float> block ((size_t) blockSize);
+
+        for (juce::int64 position = 0; position < (juce::int64) sampleRate; position += blockSize)
+        {
+            for (int n = 0; n < blockSize; ++n)
+            {
+                auto phase = juce::MathConstants<double>::twoPi * 50.0 * (double) (position + n) / sampleRate;
+                block[(size_t) n] = amplitude * (float) (std::sin (phase) + std::sin (3.0 * phase + 0.7));
+            }
+
+            tracker.process (block.data(), blockSize);
+        }
+    }
+}
+
+TEST_CASE ("Tone tracker", "[tracker]")
+{
+    ToneTracker tracker;
+    tracker.prepare (sampleRate);
+    tracker.setTargets ({ 50.0f, 49.7f, 150.0f });
+    play (tracker);
+
+    REQUIRE (tracker.getNumTargets() == 3);
+
+    SECTION ("Frequencies fitted to the window")
+    {
+        CHECK (std::abs (tracker.getTrackedFrequency (0) - 50.0f) < 0.001f);
+        CHECK (std::abs (tracker.getTrackedFrequency (2) - 150.0f) < 0.001f);
+
+        // Five cycles don't fit 49.7 Hz exactly, so it's moved to the nearest that does
+        auto windowLength = std::round (5.0 * sampleRate / 49.7);
+        CHECK (std::abs (tracker.getTrackedFrequency (1) - (float) (5.0 * sampleRate / windowLength)) < 0.001f);
+    }
+
+    SECTION ("Levels")
+    {
+        // Half a second, long after the 100 ms window has filled
+        std::vector<float> trace (500);
+        auto expectedDb = juce::Decibels::gainToDecibels (amplitude) - 6.0206f;
+
+        for (int target : { 0, 2 })
+        {
+            REQUIRE (tracker.readTrace (target, trace.data(), (int) trace.size()) == (int) trace.size());
+
+            for (auto levelDb : trace)
+                CHECK (std::abs (levelDb - expectedDb) < 0.01f);
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#include "SpectrumWeighting.h"
+#include <catch2/catch_test_macros.hpp>
+
+// The weighting curves against the nominal values tabled in IEC 61672-1, which
+// are given to 0.1 dB, and the tilt around its 1 kHz pivot
+TEST_CASE ("Weighting curves", "[weighting]")
+{
+    using Curve = SpectrumWeighting::Curve;
+
+    SECTION ("A-weighting")
+    {
+        CHECK (std::abs (SpectrumWeighting::getCurveDb (Curve::a, 100.0) + 19.1f) < 0.05f);
+        CHECK (std::abs (SpectrumWeighting::getCurveDb (Curve::a, 1000.0)) < 0.01f);
+        CHECK (std::abs (SpectrumWeighting::getCurveDb (Curve::a, 10000.0) + 2.5f) < 0.05f);
+    }
+
+    SECTION ("C-weighting")
+    {
+        CHECK (std::abs (SpectrumWeighting::getCurveDb (Curve::c, 31.5) + 3.0f) < 0.05f);
+        CHECK (std::abs (SpectrumWeighting::getCurveDb (Curve::c, 1000.0)) < 0.01f);
+    }
+
+    SECTION ("Z is flat")
+    {
+        for (auto frequency : { 20.0, 1000.0, 20000.0 })
+            CHECK (SpectrumWeighting::getCurveDb (Curve::z, frequency) == 0.0f);
+    }
+
+    SECTION ("Tilt")
+    {
+        CHECK (std::abs (SpectrumWeighting::getGainDb (Curve::z, 3.0f, 1000.0)) < 0.001f);
+        CHECK (std::abs (SpectrumWeighting::getGainDb (Curve::z, 3.0f, 2000.0) - 3.0f) < 0.001f);
+        CHECK (std::abs (SpectrumWeighting::getGainDb (Curve::z, 3.0f, 500.0) + 3.0f) < 0.001f);
+        CHECK (std::abs (SpectrumWeighting::getGainDb (Curve::z, 3.0f, 8000.0) - 9.0f) < 0.001f);
+        CHECK (std::abs (SpectrumWeighting::getGainDb (Curve::z, -4.5f, 4000.0) + 9.0f) < 0.001f);
+
+        // The tilt adds to the curve
+        CHECK (std::abs (SpectrumWeighting::getGainDb (Curve::a, 3.0f, 100.0)
+                         - (SpectrumWeighting::getCurveDb (Curve::a, 100.0) - 3.0f * (float) std::log2 (10.0))) < 0.001f);
+    }
+
+    SECTION ("Per-bin gains")
+    {
+        constexpr int fftSize = 2048;
+        constexpr double sampleRate = 48000.0;
+
+        SpectrumWeighting weighting (fftSize);
+        weighting.prepare (sampleRate);
+        CHECK (weighting.update() == nullptr);
+
+        weighting.setCurve (Curve::a);
+        weighting.setTilt (3.0f);
+        const auto* gains = weighting.update();
+        REQUIRE (gains != nullptr);
+
+        for (int bin : { 1, 5, 43, 427 })
+        {
+            auto frequency = bin * sampleRate / fftSize;
+            auto expected = SpectrumWeighting::getGainDb (Curve::a, 3.0f, frequency);
+            CHECK (std::abs (juce::Decibels::gainToDecibels (gains[bin]) - expected) < 0.001f);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+/*
+==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 4:08:42am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+// Console overview of every analyzer instance exporting to shared memory.
+// Refreshes twice a second until interrupted.
+
+#include "SpectrumReader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+
+namespace
+{
+    constexpr int numBands = 24;
+    constexpr float minFrequency = 20.0f;
+    constexpr float floorDb = -80.0f;
+    constexpr int barHeight = 8;
+
+    float toDecibels (float level)
+    {
+        return level > 0.0f ? std::max (floorDb, 20.0f * std::log10 (level)) : floorDb;
+    }
+
+    // Loudest bin in each log-spaced band, in dB
+    void getBands (const SpectrumReader::Info& info, const std::vector<float>& levels, float* bands)
+    {
+        auto nyquist = (float) info.sampleRate * 0.5f;
+        auto binWidth = (float) info.sampleRate / (float) info.fftSize;
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto low  = minFrequency * std::pow (nyquist / minFrequency, (float) band / numBands);
+            auto high = minFrequency * std::pow (nyquist / minFrequency, (float) (band + 1) / numBands);
+            auto first = std::clamp ((int) (low / binWidth), 0, (int) levels.size() - 1);
+            auto last  = std::clamp ((int) (high / binWidth), first, (int) levels.size() - 1);
+
+            auto loudest = 0.0f;
+
+            for (int bin = first; bin <= last; ++bin)
+                loudest = std::max (loudest, levels[(size_t) bin]);
+
+            bands[band] = toDecibels (loudest);
+        }
+    }
+
+    void printInstance (const SpectrumReader::Info& info, const SpectrumReader::Frame& frame, double framesPerSecond)
+    {
+        auto strongest = std::max_element (frame.levels.begin(), frame.levels.end());
+        auto strongestBin = (int) (strongest - frame.levels.begin());
+        auto strongestFrequency = (double) strongestBin * info.sampleRate / info.fftSize;
+
+        std::printf ("[%d] %-24s pid %-7lld %6.0f Hz  %s  %5.1f fps  peak %7.1f Hz %6.1f dB\n",
+                     info.index,
+                     info.name.empty() ? "(unnamed)" : info.name.c_str(),
+                     (long long) info.processId,
+                     info.sampleRate,
+                     info.channelMode == SharedSpectrum::stereo ? "stereo" : "mono  ",
+                     framesPerSecond,
+                     strongestFrequency,
+                     (double) toDecibels (*strongest));
+
+        float bands[numBands];
+        getBands (info, frame.levels, bands);
+
+        for (int row = barHeight; row > 0; --row)
+        {
+            auto threshold = floorDb * (1.0f - (float) row / barHeight);
+            std::printf ("    ");
+
+            for (int band = 0; band < numBands; ++band)
+                std::printf ("%s", bands[band] >= threshold ? "## " : "   ");
+
+            std::printf ("\n");
+        }
+
+        std::printf ("\n");
+    }
+}
+
+int main()
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct Tracked
+    {
+        std::unique_ptr<SpectrumReader> reader;
+        std::uint64_t lastFrames = 0;
+        Clock::time_point lastTime;
+    };
+
+    std::map<int, Tracked> instances;
+
+    for (;;)
+    {
+        // Pick up new instances and drop the ones that have gone away
+        for (auto index : SpectrumReader::findInstances())
+        {
+            if (instances.count (index) != 0)
+                continue;
+
+            auto reader = std::make_unique<SpectrumReader>();
+
+            if (reader->open (index))
+                instances[index] = { std::move (reader), 0, Clock::now() };
+        }
+
+        for (auto it = instances.begin(); it != instances.end();)
+            it = it->second.reader->isWriterAlive() ? std::next (it) : instances.erase (it);
+
+        std::printf ("\033[2J\033[H%zu analyzer instance(s)\n\n", instances.size());
+
+        SpectrumReader::Frame frame;
+
+        for (auto& [index, tracked] : instances)
+        {
+            auto info = tracked.reader->getInfo();
+            auto now = Clock::now();
+            auto seconds = std::chrono::duration<double> (now - tracked.lastTime).count();
+            auto framesPerSecond = tracked.lastFrames != 0 && seconds > 0.0
+                                       ? (double) (info.framesWritten - tracked.lastFrames) / seconds
+                                       : 0.0;
+
+            tracked.lastFrames = info.framesWritten;
+            tracked.lastTime = now;
+
+            if (tracked.reader->readLatest (frame))
+                printInstance (info, frame, framesPerSecond);
+            else
+                std::printf ("[%d] %s: no frames yet\n\n", index, info.name.c_str());
+        }
+
+        std::fflush (stdout);
+        std::this_thread::sleep_for (std::chrono::milliseconds (500));
+    }
+}
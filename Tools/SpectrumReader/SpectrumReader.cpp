@@ -0,0 +1,174 @@
+/*
+==============================================================================
+
+    SpectrumReader.cpp
+    Created: 19 Oct 2026 4:08:42am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#include "SpectrumReader.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//==============================================================================
+static std::string getSegmentName (int index)
+{
+    return SharedSpectrum::namePrefix + std::to_string (index);
+}
+
+// atomic_ref can't wrap a const object before C++26, a plain load is all we need
+static std::uint32_t loadMagic (const SharedSpectrum::Header* header)
+{
+    return std::atomic_ref<std::uint32_t> (const_cast<std::uint32_t&> (header->magic)).load (std::memory_order_acquire);
+}
+
+static bool isProcessAlive (std::int64_t processId)
+{
+    return processId > 0 && (kill ((pid_t) processId, 0) == 0 || errno != ESRCH);
+}
+
+//==============================================================================
+SpectrumReader::~SpectrumReader()
+{
+    close();
+}
+
+std::vector<int> SpectrumReader::findInstances()
+{
+    std::vector<int> indices;
+
+    for (int i = 0; i < SharedSpectrum::maxInstances; ++i)
+    {
+        SpectrumReader reader;
+
+        if (reader.open (i) && reader.isWriterAlive())
+            indices.push_back (i);
+    }
+
+    return indices;
+}
+
+bool SpectrumReader::open (int newIndex)
+{
+    close();
+
+    auto fd = shm_open (getSegmentName (newIndex).c_str(), O_RDONLY, 0);
+
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    void* mem = MAP_FAILED;
+
+    if (fstat (fd, &info) == 0 && (std::size_t) info.st_size >= sizeof (SharedSpectrum::Header))
+        mem = mmap (nullptr, (std::size_t) info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+    ::close (fd);
+
+    if (mem == MAP_FAILED)
+        return false;
+
+    auto* newHeader = static_cast<const SharedSpectrum::Header*> (mem);
+
+    // Check the writer has finished setting up, and that we agree on the layout
+    auto magic = loadMagic (newHeader);
+    auto expectedSize = (std::size_t) newHeader->headerSize + (std::size_t) newHeader->slotSize * newHeader->numSlots;
+
+    if (magic != SharedSpectrum::magic
+        || newHeader->version != SharedSpectrum::version
+        || newHeader->slotSize < SharedSpectrum::getSlotSize (newHeader->numBins)
+        || expectedSize > (std::size_t) info.st_size)
+    {
+        munmap (mem, (std::size_t) info.st_size);
+        return false;
+    }
+
+    header = newHeader;
+    mappedSize = (std::size_t) info.st_size;
+    index = newIndex;
+    return true;
+}
+
+void SpectrumReader::close()
+{
+    if (header == nullptr)
+        return;
+
+    munmap (const_cast<SharedSpectrum::Header*> (header), mappedSize);
+    header = nullptr;
+    mappedSize = 0;
+    index = -1;
+}
+
+bool SpectrumReader::isWriterAlive() const
+{
+    if (header == nullptr)
+        return false;
+
+    // The writer clears the magic number when it closes
+    auto magic = loadMagic (header);
+    return magic == SharedSpectrum::magic && isProcessAlive (header->processId);
+}
+
+SpectrumReader::Info SpectrumReader::getInfo() const
+{
+    Info info;
+
+    if (header == nullptr)
+        return info;
+
+    info.index = index;
+    info.name = std::string (header->name, strnlen (header->name, SharedSpectrum::nameLength));
+    info.processId = header->processId;
+    info.sampleRate = header->sampleRate;
+    info.fftSize = header->fftSize;
+    info.numBins = header->numBins;
+    info.channelMode = header->channelMode;
+    info.framesWritten = header->framesWritten.load (std::memory_order_acquire);
+    return info;
+}
+
+bool SpectrumReader::readLatest (Frame& frame, int maxRetries) const
+{
+    if (header == nullptr)
+        return false;
+
+    frame.levels.resize (header->numBins);
+
+    for (int attempt = 0; attempt < maxRetries; ++attempt)
+    {
+        auto written = header->framesWritten.load (std::memory_order_acquire);
+
+        if (written == 0)
+            return false;
+
+        auto slotIndex = (written - 1) % header->numSlots;
+        auto* slot = reinterpret_cast<const SharedSpectrum::Slot*> (reinterpret_cast<const std::uint8_t*> (header)
+                                                                     + header->headerSize
+                                                                     + slotIndex * header->slotSize);
+
+        auto before = slot->sequence.load (std::memory_order_acquire);
+
+        if (before & 1u)
+            continue;
+
+        frame.frameNumber = slot->frameNumber;
+        frame.time = slot->time;
+        std::memcpy (frame.levels.data(), slot->getLevels(), header->numBins * sizeof (float));
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+
+        if (slot->sequence.load (std::memory_order_relaxed) == before)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,81 @@
+/*
+==============================================================================
+
+    SpectrumReader.h
+    Created: 19 Oct 2026 4:08:42am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+#pragma once
+
+#include "SharedSpectrumLayout.h"
+
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*
+    Reads the frames that analyzer instances export to shared memory, without
+    going through the plugin or JUCE. POSIX only.
+
+        for (auto index : SpectrumReader::findInstances())
+        {
+            SpectrumReader reader;
+            SpectrumReader::Frame frame;
+
+            if (reader.open (index) && reader.readLatest (frame))
+                ...
+        }
+*/
+
+class SpectrumReader
+{
+public:
+    struct Info
+    {
+        int index = -1;
+        std::string name;
+        std::int64_t processId = 0;
+        double sampleRate = 0.0;
+        std::uint32_t fftSize = 0;
+        std::uint32_t numBins = 0;
+        std::uint32_t channelMode = 0;
+        std::uint64_t framesWritten = 0;
+    };
+
+    struct Frame
+    {
+        std::uint64_t frameNumber = 0;
+        double time = 0.0;
+        std::vector<float> levels;
+    };
+
+    SpectrumReader() = default;
+    ~SpectrumReader();
+
+    SpectrumReader (const SpectrumReader&) = delete;
+    SpectrumReader& operator= (const SpectrumReader&) = delete;
+
+    // Indices of all the segments with a live writer
+    static std::vector<int> findInstances();
+
+    bool open (int index);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // False once the writer has closed the segment or its process has gone
+    bool isWriterAlive() const;
+
+    Info getInfo() const;
+
+    // Copies the newest complete frame. Gives up after maxRetries if the
+    // writer keeps overwriting the slot while we read it.
+    bool readLatest (Frame& frame, int maxRetries = 16) const;
+
+private:
+    const SharedSpectrum::Header* header = nullptr;
+    std::size_t mappedSize = 0;
+    int index = -1;
+};
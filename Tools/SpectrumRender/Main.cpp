@@ -0,0 +1,75 @@
+/*
+==============================================================================
+
+    Main.cpp
+    Created: 19 Oct 2026 4:33:17am
+    Author:  Nic Becker
+
+==============================================================================
+*/
+
+// Renders the analyzer's display for audio files to PNGs, for QC reports:
+//
+//   SpectrumRender [--frames] [--fps=30] [--size=1200x600] [--threads=N] [--out=folder] files...
+//
+// By default each file gets one long-term spectrum image. With --frames it
+// gets a folder of images instead, one per tick of --fps.
+
+#include "OfflineRenderer.h"
+
+#include <iostream>
+
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.size() == 0 || args.containsOption ("--help|-h"))
+    {
+        std::cout << "Usage: " << args.executableName
+                  << " [--frames] [--fps=30] [--size=1200x600] [--threads=N] [--out=folder] files...\n";
+        return 0;
+    }
+
+    // The Analyzer is a component, it wants a message thread even without a window
+    juce::ScopedJuceInitialiser_GUI gui;
+
+    OfflineRenderer::Settings settings;
+
+    if (args.containsOption ("--frames"))
+        settings.output = OfflineRenderer::Output::frames;
+
+    if (args.containsOption ("--fps"))
+        settings.framesPerSecond = juce::jmax (0.0, args.getValueForOption ("--fps").getDoubleValue());
+
+    if (args.containsOption ("--size"))
+    {
+        auto size = args.getValueForOption ("--size");
+        settings.width  = juce::jmax (200, size.upToFirstOccurrenceOf ("x", false, true).getIntValue());
+        settings.height = juce::jmax (100, size.fromFirstOccurrenceOf ("x", false, true).getIntValue());
+    }
+
+    auto numThreads = args.containsOption ("--threads") ? args.getValueForOption ("--threads").getIntValue()
+                                                        : juce::SystemStats::getNumCpus();
+
+    auto outputDirectory = juce::File::getCurrentWorkingDirectory();
+
+    if (args.containsOption ("--out"))
+        outputDirectory = outputDirectory.getChildFile (args.getValueForOption ("--out"));
+
+    juce::Array<juce::File> files;
+
+    for (const auto& arg : args.arguments)
+        if (not arg.isOption())
+            files.add (arg.resolveAsFile());
+
+    OfflineRenderer renderer (settings);
+    auto errors = renderer.render (files, outputDirectory, numThreads);
+
+    for (const auto& error : errors)
+        std::cerr << error << "\n";
+
+    std::cout << "Rendered " << files.size() - errors.size() << " of " << files.size()
+              << " files to " << outputDirectory.getFullPathName() << "\n";
+
+    return errors.isEmpty() ? 0 : 1;
+}